@@ -41,6 +41,12 @@ class nixlBackendInitParams {
 
         bool              enableProgTh;
         nixlTime::us_t    pthrDelay;
+
+        // The agent's thread drives progress instead of one in the backend,
+        // see nixlBackendEngine::pthrRound. With pthrWait it also blocks on
+        // the backend's pthrFd when idle.
+        bool              agentProgTh = false;
+        bool              pthrWait    = false;
 };
 
 // Pure virtual class to have a common pointer type
@@ -95,8 +101,10 @@ class nixlMetaDesc : public nixlBasicDesc {
 
         // Main use case is to take the BasicDesc from another object, so just
         // the metadata part is separately copied here, used in DescList
+        // Remote sections set metadataP on first use while other threads
+        // might populate from them, so it's read atomically (a plain load).
         inline void copyMeta (const nixlMetaDesc &meta) {
-            this->metadataP = meta.metadataP;
+            this->metadataP = __atomic_load_n(&meta.metadataP, __ATOMIC_ACQUIRE);
         }
 
         inline void print(const std::string &suffix) const {
@@ -98,6 +98,20 @@ class nixlBackendEngine {
         virtual nixl_status_t connect(const std::string &remote_agent) = 0;
         virtual nixl_status_t disconnect(const std::string &remote_agent) = 0;
 
+        // Non-blocking connect. If NIXL_IN_PROG is returned, checkConnect should be
+        // called until success or error. By default falls back to the blocking one.
+        virtual nixl_status_t connectAsync(const std::string &remote_agent) {
+            return connect(remote_agent);
+        }
+        virtual nixl_status_t checkConnect(const std::string &remote_agent) {
+            return NIXL_SUCCESS;
+        }
+
+        // Appends the remote agents found dead since the last call. Their
+        // transfers in flight have failed and connections were closed, and
+        // the agent drops their metadata as in invalidateRemoteMD.
+        virtual void getFailedConns(std::vector<std::string> &remote_agents) {}
+
         // Remove loaded local or remtoe metadata for target
         virtual nixl_status_t unloadMD (nixlBackendMD* input) = 0;
 
@@ -159,10 +173,58 @@ class nixlBackendEngine {
             return NIXL_ERR_BACKEND;
         }
 
+        // Appends received notifications to the arena, and returns how many.
+        // Backends can override it to queue notifications without copies.
+        virtual int drainNotifs(nixlNotifArena &arena) {
+            notif_list_t notif_list;
+            int ret = getNotifs(notif_list);
+            if (ret < 0)
+                return ret;
+            for (auto & elm : notif_list)
+                arena.add(elm.first.data(), elm.first.size(),
+                          elm.second.data(), elm.second.size());
+            return notif_list.size();
+        }
+
+        // Delivers notifications to cb in batches from the progress thread,
+        // instead of queueing them, null to stop. No call is running when
+        // this returns, so it can't be used from the callback.
+        virtual nixl_status_t setNotifCallback(nixl_notif_cb_t cb, void* arg) {
+            return NIXL_ERR_NOT_ALLOWED;
+        }
+
+
+        // *** Needs to be implemented if supportsSignal() is true *** //
+        // Determines if a backend can add to a remote counter after a transfer
+        virtual bool supportsSignal () const { return false; }
+
+        // Same as postXfer, and after the data has landed atomically adds 1
+        // to the 8 byte counter at signal, which is in remote memory
+        virtual nixl_status_t postXferSignal (const nixl_meta_dlist_t &local,
+                                              const nixl_meta_dlist_t &remote,
+                                              const nixl_xfer_op_t &operation,
+                                              const std::string &remote_agent,
+                                              const std::string &notif_msg,
+                                              const nixlMetaDesc &signal,
+                                              nixlBackendReqH* &handle) {
+            return NIXL_ERR_BACKEND;
+        }
 
         // *** Needs to be implemented if supportsProgTh() is true *** //
 
         // Force backend engine worker to progress.
         virtual int progress() { return 0; }
+
+        // With agentProgTh the agent's thread calls pthrAttach once, then
+        // pthrRound in its loop. A round also hands over what the thread
+        // received, e.g., notifications, and returns 0 if it found no work.
+        virtual void pthrAttach() {}
+        virtual int pthrRound() { return progress(); }
+
+        // With pthrWait, an fd that becomes readable when there's work, or
+        // -1 if the backend can't be waited on. pthrArm is called before
+        // waiting, and returns false if work is already pending.
+        virtual int pthrFd() { return -1; }
+        virtual bool pthrArm() { return false; }
 };
 #endif
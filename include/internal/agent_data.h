@@ -17,9 +17,30 @@
 #ifndef __AGENT_DATA_H_
 #define __AGENT_DATA_H_
 
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include "str_tools.h"
+#include "nixl_rwlock.h"
 #include "mem_section.h"
 
+typedef std::shared_ptr<nixlRemoteSection> remote_section_ptr_t;
+
+// Remote agents' information. Once published through nixlAgentData, it's
+// not modified anymore. Updates make a new copy and publish it instead, so
+// readers don't need a lock. An old copy, and the sections only it points
+// to, are freed when its last reader releases it.
+class nixlRemoteState {
+    public:
+        std::unordered_map<std::string, remote_section_ptr_t,
+                           std::hash<std::string>, strEqual> sections;
+        std::unordered_map<std::string, backend_set_t,
+                           std::hash<std::string>, strEqual> backends;
+};
+
+typedef std::shared_ptr<const nixlRemoteState> remote_state_ptr_t;
+
 class nixlAgentData {
     private:
         std::string     name;
@@ -34,14 +55,188 @@ class nixlAgentData {
 
         nixlLocalSection                                       memorySection;
 
-        std::unordered_map<std::string, nixlRemoteSection*,
-                           std::hash<std::string>, strEqual>   remoteSections;
-        std::unordered_map<std::string, backend_set_t,
-                           std::hash<std::string>, strEqual>   remoteBackends;
+        // Accessed only through getRemote/setRemote
+        remote_state_ptr_t                                     remoteState;
+
+        // Writers of backends and memorySection take it exclusively, and
+        // readers of them shared. Control calls that change remoteState are
+        // serialized by ctrlLock, which is taken before localLock if both are.
+        nixlRWLock                                             localLock;
+        std::mutex                                             ctrlLock;
+
+        // Notification callback given to the backends, set under ctrlLock
+        nixl_notif_cb_t                                        notifCb;
+        void*                                                  notifCbArg;
+
+        // Incremented on each change of memorySection (with localLock held)
+        // or remoteState, so nixlXferContexts know when to refresh their view
+        std::atomic<uint64_t>                                  localGen;
+        std::atomic<uint64_t>                                  remoteGen;
+
+        // Progress thread of the agent, see nixlAgentConfig::agentProgThread.
+        // progEpoll has progWake and the backends' fds if it can block.
+        std::thread                                            progThread;
+        std::atomic<bool>                                      progStop;
+        std::atomic<bool>                                      progWaiting;
+        int                                                    progEpoll;
+        int                                                    progWake;
+
+        // Running requests posted with a timeout, by deadline. If the
+        // progress thread runs, it marks the expired ones, otherwise
+        // getXferStatus checks the clock.
+        std::mutex                                             deadlineLock;
+        std::multimap<uint64_t, nixlXferReqH*>                 deadlines;
+        std::atomic<size_t>                                    deadlineCount;
+
+        // Staging buffers (see addStagingBuffers), of the same memory type
+        // and length, and the backends they're registered with. Staged
+        // requests take free ones when created, and give them back when
+        // invalidated.
+        std::mutex                                             stagingLock;
+        std::vector<nixlBasicDesc>                             stagingBufs;
+        nixl_mem_t                                             stagingMem;
+        std::vector<nixlBackendH*>                             stagingBackends;
+        std::vector<int>                                       stagingFree;
+
+        // Running staged requests, that the progress thread moves along.
+        // It only try-locks them under chainLock, so their threads can take
+        // chainLock with their own lock held.
+        std::mutex                                             chainLock;
+        std::vector<nixlStagedXfer*>                           chains;
+        std::atomic<size_t>                                    chainCount;
 
         nixlAgentData(const std::string &name, const nixlAgentConfig &cfg);
         ~nixlAgentData();
 
+        void progressStart();
+        void progressStop();
+        void progressFunc();
+
+        // Called by the request's thread, expireDeadlines by the progress one
+        void setDeadline(nixlXferReqH* req, uint64_t deadline);
+        void clearDeadline(nixlXferReqH* req);
+        bool deadlinePassed(nixlXferReqH* req);
+        // Returns ms until the next deadline, or -1 if there's none
+        int  expireDeadlines();
+        // Stops tracking the running transfer of req, if any
+        void stopXfer(nixlXferReqH* req);
+
+        // Posts req with its timeout, after stopping its previous transfer
+        nixl_status_t postXfer(nixlXferReqH* req);
+        // Posts req again while ret is a retriable error and it has retries
+        // left, and returns the status of the last attempt
+        nixl_status_t retryXfer(nixlXferReqH* req, nixl_status_t ret);
+        // Moves req to another backend that has its memory on both sides
+        bool failoverXfer(nixlXferReqH* req);
+        // Populates req for the first backend other than its current one
+        // that has local, remote and the counter (if not empty) registered,
+        // with localLock held
+        bool selectBackend(nixlXferReqH* req, const nixl_xfer_dlist_t &local,
+                           const nixl_xfer_dlist_t &remote,
+                           const nixl_xfer_dlist_t &counter,
+                           const remote_section_ptr_t &section,
+                           const nixlBackendEngine* only = nullptr);
+
+        // postXferReq and getXferStatus of a regular request
+        nixl_status_t submitXfer(nixlXferReqH* req, uint64_t timeout_us);
+        nixl_status_t xferStatus(nixlXferReqH* req);
+
+        // Makes a request going through staging buffers. Its legs use the
+        // given backends for the local and remote side, or any if null.
+        nixl_status_t createStaged(const nixl_xfer_dlist_t &local_descs,
+                                   const nixl_xfer_dlist_t &remote_descs,
+                                   const std::string &remote_agent,
+                                   const std::string &notif_msg,
+                                   const nixl_xfer_op_t &operation,
+                                   const nixlBackendH* local_backend,
+                                   const nixlBackendH* remote_backend,
+                                   nixlXferReqH* &req_handle);
+        // True if some backend has local registered, and some backend of
+        // remote_agent has remote, though maybe not the same one
+        bool coveredApart(const nixl_xfer_dlist_t &local,
+                          const nixl_xfer_dlist_t &remote,
+                          const std::string &remote_agent);
+        // Makes one leg of a staged request, between staging buffers and
+        // the other side, or returns nullptr if no backend has both
+        nixlXferReqH* createLeg(const nixl_xfer_dlist_t &staging,
+                                const nixl_xfer_dlist_t &other,
+                                const std::string &remote_agent,
+                                const std::string &notif_msg,
+                                const nixl_xfer_op_t &operation,
+                                const nixlBackendH* backend);
+        // Posts the legs that can go, and checks the running ones, with the
+        // request's lock held
+        nixl_status_t progressStaged(nixlStagedXfer* st);
+        void          stopStaged(nixlStagedXfer* st);
+        // Gives the request's buffers back to the pool, once it's untracked
+        void          releaseStaged(nixlStagedXfer* st);
+        // Has the progress thread move a running staged request along, or
+        // stop doing it
+        void          trackStaged(nixlStagedXfer* st);
+        void          untrackStaged(nixlStagedXfer* st);
+        // Called by the progress thread
+        void          progressChains();
+
+        // Drops the remote agent's metadata and connections, with ctrlLock held
+        nixl_status_t invalidateRemote(const std::string &remote_agent);
+        // Invalidates the remote agents that engine found dead
+        void dropFailedPeers(nixlBackendEngine* engine);
+
+        // Snapshot of the remote state, valid as long as it's held
+        inline remote_state_ptr_t getRemote() const {
+            return std::atomic_load(&remoteState);
+        }
+        // Called with ctrlLock held
+        inline void setRemote(const remote_state_ptr_t &state) {
+            std::atomic_store(&remoteState, state);
+            remoteGen.fetch_add(1, std::memory_order_release);
+        }
+        // Called with localLock held exclusively
+        inline void localChanged() {
+            localGen.fetch_add(1, std::memory_order_release);
+        }
+
+    friend class nixlAgent;
+    friend class nixlXferContext;
+    friend class nixlXferContextData;
+};
+
+// State of a nixlXferContext, only accessed by its thread
+class nixlXferContextData {
+    private:
+        nixlAgentData*       agentData;
+
+        // Copy of the agent's memorySection, as of localGen
+        nixlSectionView      localView;
+        uint64_t             localGen;
+
+        // Snapshot of the agent's remote state, as of remoteGen, and the
+        // number of requests of this context that were created from it
+        remote_state_ptr_t   remote;
+        uint64_t             remoteGen;
+        size_t               remoteRefs;
+
+        // Older snapshots that requests of this context still refer to
+        std::map<const nixlRemoteState*,
+                 std::pair<remote_state_ptr_t, size_t>> retired;
+
+        // Last remote agent looked up in the snapshot
+        std::string          lastAgent;
+        nixlRemoteSection*   lastSection;
+        const backend_set_t* lastBackends;
+
+        // Released requests, reused with their descriptor lists' storage
+        std::vector<nixlXferReqH*> freeReqs;
+
+        nixlXferContextData(nixlAgentData* agent_data);
+        ~nixlXferContextData();
+
+        void refreshLocal();
+        void refreshRemote();
+        // Aborts req if running, unpins its snapshot and adds it to freeReqs
+        void release(nixlXferReqH* req);
+
+    friend class nixlXferContext;
     friend class nixlAgent;
 };
 
@@ -64,6 +259,7 @@ class nixlBackendH {
 
     friend class nixlAgentData;
     friend class nixlAgent;
+    friend class nixlXferContext;
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include <array>
 #include <string>
 #include <set>
+#include <mutex>
 #include "nixl_descriptors.h"
 #include "nixl.h"
 #include "backend/backend_engine.h"
@@ -39,12 +40,36 @@ class nixlMemSection {
         // Replica of what Agent has, but tiny in size and helps with modularity
         backend_map_t backendToEngineMap;
 
+    private:
+        template <class Q>
+        nixlBackendEngine* findQueryT (const Q &query,
+                                       const nixl_mem_t &remote_nixl_mem,
+                                       const backend_set_t &remote_backends,
+                                       nixl_meta_dlist_t &resp) const;
+
     public:
         nixlMemSection () {};
 
         nixl_status_t populate (const nixl_xfer_dlist_t &query,
                                 const nixl_backend_t &nixl_backend,
                                 nixl_meta_dlist_t &resp) const;
+        // Each strided descriptor is checked once to be covered by a single
+        // descriptor in the section, and expanded to its elements in resp,
+        // which should be unsorted.
+        nixl_status_t populate (const nixl_strided_dlist_t &query,
+                                const nixl_backend_t &nixl_backend,
+                                nixl_meta_dlist_t &resp) const;
+
+        // Find a nixlBasicDesc in the section, if available fills the resp based
+        // on that, and returns the backend pointer that can use the resp
+        nixlBackendEngine* findQuery (const nixl_xfer_dlist_t &query,
+                                      const nixl_mem_t &remote_nixl_mem,
+                                      const backend_set_t &remote_backends,
+                                      nixl_meta_dlist_t &resp) const;
+        nixlBackendEngine* findQuery (const nixl_strided_dlist_t &query,
+                                      const nixl_mem_t &remote_nixl_mem,
+                                      const backend_set_t &remote_backends,
+                                      nixl_meta_dlist_t &resp) const;
 
         virtual ~nixlMemSection () = 0; // Making the class abstract
 };
@@ -66,32 +91,68 @@ class nixlLocalSection : public nixlMemSection {
         nixl_status_t remDescList (const nixl_meta_dlist_t &mem_elms,
                                    nixlBackendEngine* backend);
 
-        // Find a nixlBasicDesc in the section, if available fills the resp based
-        // on that, and returns the backend pointer that can use the resp
-        nixlBackendEngine* findQuery (const nixl_xfer_dlist_t &query,
-                                      const nixl_mem_t &remote_nixl_mem,
-                                      const backend_set_t &remote_backends,
-                                      nixl_meta_dlist_t &resp) const;
-
         nixl_status_t serialize(nixlSerDes* serializer) const;
 
         ~nixlLocalSection();
+
+    friend class nixlSectionView;
+};
+
+
+// Private copy of a local section's descriptor lists, so one thread can look
+// them up without locking. The backend metadata is not copied but shared with
+// the original, so the copy has to be refreshed whenever the original changes.
+class nixlSectionView : public nixlMemSection {
+    public:
+        nixlSectionView () {};
+
+        void copyFrom (const nixlLocalSection &section);
+
+        ~nixlSectionView();
 };
 
 
 class nixlRemoteSection : public nixlMemSection {
     private:
         std::string agentName;
+        // Packed metaInfo of the descriptors that are not loaded into the
+        // backend yet (metadataP is nullptr in sectionMap), per section.
+        std::map<section_key_t, nixl_reg_dlist_t*> packedMap;
+        // Serializes loading of packed metadata by concurrent populate calls
+        std::mutex loadLock;
+        // False if another section took over the loaded metadata
+        bool ownsMD;
+
+        nixl_status_t loadPacked (const section_key_t &sec_key,
+                                  const int &index);
+        // Fills in the metadata of populated descriptors that's not loaded
+        nixl_status_t loadResp (const section_key_t &sec_key,
+                                nixl_meta_dlist_t &resp);
 
         nixl_status_t addDescList (
-                           const nixl_reg_dlist_t &mem_elms,
+                           nixl_reg_dlist_t &mem_elms,
                            nixlBackendEngine *backend);
     public:
         nixlRemoteSection (const std::string &agent_name,
                            backend_map_t &engine_map);
+        // Copies a section with local data, with the same metadata pointers.
+        // Only for local data, as nothing is loaded later. Once the copy
+        // replaces prev, disownMD is called on prev so only one unloads them.
+        nixlRemoteSection (const nixlRemoteSection* prev);
+        inline void disownMD() { ownsMD = false; }
 
         nixl_status_t loadRemoteData (nixlSerDes* deserializer);
 
+        // Same as nixlMemSection::populate, but the backend metadata of the
+        // matched descriptors is loaded on first use and cached in the section.
+        // Can be called from multiple threads once the section is loaded.
+        nixl_status_t populate (const nixl_xfer_dlist_t &query,
+                                const nixl_backend_t &nixl_backend,
+                                nixl_meta_dlist_t &resp);
+        nixl_status_t populate (const nixl_strided_dlist_t &query,
+                                const nixl_backend_t &nixl_backend,
+                                nixl_meta_dlist_t &resp);
+
         // When adding self as a remote agent for local operations
         nixl_status_t loadLocalData (const nixl_meta_dlist_t& mem_elms,
                                      nixlBackendEngine* backend);
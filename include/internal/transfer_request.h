@@ -17,6 +17,16 @@
 #ifndef __TRANSFER_REQUEST_H_
 #define __TRANSFER_REQUEST_H_
 
+#include <map>
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include <memory>
+
+class nixlRemoteSection;
+class nixlRemoteState;
+class nixlStagedXfer;
+
 // Contains pointers to corresponding backend engine and its handler, and populated
 // and verified DescLists, and other state and metadata needed for a NIXL transfer
 class nixlXferReqH {
@@ -27,31 +37,134 @@ class nixlXferReqH {
         nixl_meta_dlist_t* initiatorDescs;
         nixl_meta_dlist_t* targetDescs;
 
+        // Keeps the remote metadata in targetDescs alive, even if the remote
+        // agent is invalidated or updated while the request exists
+        std::shared_ptr<nixlRemoteSection> remoteSection;
+
+        // For requests of a nixlXferContext, which keeps the remote state
+        // they were created from alive instead of remoteSection
+        nixlXferContextData*   context;
+        const nixlRemoteState* pinnedState;
+
         std::string        remoteAgent;
         std::string        notifMsg;
 
+        // Remote counter added to after the data, and the section keeping
+        // its metadata alive
+        nixl_meta_dlist_t*                 signalDescs;
+        std::shared_ptr<nixlRemoteSection> signalSection;
+
         nixl_xfer_op_t     backendOp;
         nixl_status_t      status;
 
+        // Absolute time in us the running transfer times out at, 0 if none.
+        // If queued, it's in the agent's deadlines at deadlineIt until the
+        // progress thread sets expired and removes it.
+        uint64_t           deadline;
+        bool               deadlineQueued;
+        std::multimap<uint64_t, nixlXferReqH*>::iterator deadlineIt;
+        std::atomic<bool>  expired;
+
+        // Retries left for the running post, the timeout each attempt gets,
+        // and if they can move to another backend (see xferRetries)
+        uint32_t           retriesLeft;
+        uint64_t           timeoutUs;
+        bool               failover;
+
+        // Set if the transfer goes through the agent's staging buffers, and
+        // then engine is null
+        nixlStagedXfer*    staged;
+
     public:
         inline nixlXferReqH() {
             initiatorDescs = nullptr;
             targetDescs    = nullptr;
             engine         = nullptr;
             backendHandle  = nullptr;
+            context        = nullptr;
+            pinnedState    = nullptr;
+            signalDescs    = nullptr;
+            deadline       = 0;
+            deadlineQueued = false;
+            expired        = false;
+            retriesLeft    = 0;
+            timeoutUs      = 0;
+            failover       = false;
+            staged         = nullptr;
         }
 
-        inline ~nixlXferReqH() {
-            // delete checks for nullptr itself
-            delete initiatorDescs;
-            delete targetDescs;
-            if (backendHandle != nullptr)
-                engine->releaseReqH(backendHandle);
+        inline ~nixlXferReqH();
+
+    friend class nixlAgent;
+    friend class nixlAgentData;
+    friend class nixlXferContext;
+    friend class nixlXferContextData;
+};
+
+// Transfer that no backend can do directly, moved in chunks through staging
+// buffers of the agent (see addStagingBuffers). Each chunk has two legs, which
+// are regular requests: the first moves it into a buffer, and the second out
+// of it, so chunk i can go out while chunk i+1 comes in. While it runs, the
+// agent's progress thread moves it along too, so its state is under lock.
+class nixlStagedXfer {
+    private:
+        struct chunk {
+            nixlXferReqH* legs[2];
+        };
+        std::vector<chunk> chunks;
+
+        // Buffers the request holds, by index in the agent's pool. Chunk i
+        // goes through slots[i % slots.size()].
+        std::vector<int>   slots;
+
+        // Leg of the chunks that reaches the remote agent. With a
+        // notification, the last chunk's one carries it, and is posted once
+        // the other chunks' ones have completed.
+        int                remoteLeg;
+        bool               notif;
+
+        // Legs of each kind posted and completed so far, in chunk order
+        size_t             posted[2];
+        size_t             done[2];
+
+        // Absolute time in us the transfer times out at, 0 if none
+        uint64_t           deadline;
+
+        // Status of the whole transfer, instead of the request's
+        nixl_status_t      status;
+        std::mutex         lock;
+
+    public:
+        inline nixlStagedXfer() {
+            status    = NIXL_ERR_NOT_POSTED;
+            remoteLeg = 1;
+            notif     = false;
+            posted[0] = posted[1] = 0;
+            done[0]   = done[1]   = 0;
+            deadline  = 0;
+        }
+
+        inline ~nixlStagedXfer() {
+            for (auto & c : chunks) {
+                delete c.legs[0];
+                delete c.legs[1];
+            }
         }
 
     friend class nixlAgent;
+    friend class nixlAgentData;
 };
 
+inline nixlXferReqH::~nixlXferReqH() {
+    // delete checks for nullptr itself
+    delete initiatorDescs;
+    delete targetDescs;
+    delete signalDescs;
+    delete staged;
+    if (backendHandle != nullptr)
+        engine->releaseReqH(backendHandle);
+}
+
 class nixlXferSideH {
     private:
         nixl_meta_dlist_t* descs;
@@ -59,10 +172,15 @@ class nixlXferSideH {
         nixlBackendEngine* engine;
         std::string        remoteAgent;
         bool               isLocal;
+        // Length of all descriptors if they're the same, otherwise 0
+        size_t             uniformLen;
+
+        std::shared_ptr<nixlRemoteSection> remoteSection; // Same as nixlXferReqH
 
     public:
         inline nixlXferSideH() {
-            engine = nullptr;
+            engine     = nullptr;
+            uniformLen = 0;
         }
 
         inline ~nixlXferSideH() {
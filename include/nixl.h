@@ -27,6 +27,16 @@ class nixlAgent {
     private:
         nixlAgentData* data;
 
+        // Common implementation for the descriptor list types
+        template <class Q>
+        nixl_status_t createXferReqT (const Q &local_descs,
+                                      const Q &remote_descs,
+                                      const std::string &remote_agent,
+                                      const std::string &notif_msg,
+                                      const nixl_xfer_op_t &operation,
+                                      nixlXferReqH* &req_handle,
+                                      const nixlBackendH* backend) const;
+
     public:
 
         /*** Initialization and Registering Methods ***/
@@ -52,6 +62,12 @@ class nixlAgent {
         // Make connection proactively, instead of at transfer time
         nixl_status_t makeConnection (const std::string &remote_agent);
 
+        // Non-blocking version, so many connections can be made at once.
+        // If NIXL_IN_PROG is returned, checkConnection should be called
+        // until the connection is made (NIXL_SUCCESS) or failed.
+        nixl_status_t makeConnectionAsync (const std::string &remote_agent);
+        nixl_status_t checkConnection (const std::string &remote_agent);
+
 
         /*** Transfer Request Handling ***/
 
@@ -64,20 +80,93 @@ class nixlAgent {
                                      nixlXferReqH* &req_handle,
                                      const nixlBackendH* backend = nullptr) const;
 
+        // Same with strided descriptors, e.g., for tensor slices. Each pair
+        // should have the same element length and count, strides can differ.
+        // Elements are paired in order, and each strided descriptor should be
+        // within a single registered region.
+        nixl_status_t createXferReq (const nixl_strided_dlist_t &local_descs,
+                                     const nixl_strided_dlist_t &remote_descs,
+                                     const std::string &remote_agent,
+                                     const std::string &notif_msg,
+                                     const nixl_xfer_op_t &operation,
+                                     nixlXferReqH* &req_handle,
+                                     const nixlBackendH* backend = nullptr) const;
+
+        // Makes every post of the request atomically add 1 to a uint64_t
+        // counter in the remote agent's registered memory, once the data of
+        // the transfer has landed. The target polls the counter instead of
+        // matching notifications. The backend has to support signals.
+        nixl_status_t setXferSignal (nixlXferReqH* req,
+                                     const nixlBasicDesc &remote_counter) const;
+
         // Submit a transfer request, which populates the req async handler.
-        nixl_status_t postXferReq (nixlXferReqH* req);
+        // With a timeout, the transfer is stopped if it hasn't completed
+        // timeout_us after the post, and its status is NIXL_ERR_TIMEOUT.
+        // The agent's progress thread tracks deadlines if it runs, otherwise
+        // they are checked in getXferStatus. A running request isn't
+        // changed by a repost, which returns NIXL_ERR_REPOST_ACTIVE.
+        nixl_status_t postXferReq (nixlXferReqH* req,
+                                   const uint64_t timeout_us = 0);
 
-        // Check the status of transfer requests
+        // Check the status of transfer requests. Transfers to a remote agent
+        // found dead fail, and its metadata is invalidated, by this call or
+        // by the agent's progress thread. It has to be loaded again to
+        // reach the agent after it restarts.
         nixl_status_t getXferStatus (nixlXferReqH* req);
 
+        // Stops a running transfer, and its status becomes
+        // NIXL_ERR_NOT_POSTED. The request can be posted again. Ops the
+        // backend already started may still land, which a repost covers
+        // when it completes. No-op if the transfer isn't running.
+        nixl_status_t cancelXferReq (nixlXferReqH* req);
+
         // Invalidate transfer request if we no longer need it.
-        // Will also abort a running transfer.
+        // Will also abort a running transfer. Requests created through a
+        // nixlXferContext go back to it, so are invalidated by its thread.
         void invalidateXferReq (nixlXferReqH* req);
 
 
+        /*** Staged transfers ***/
+
+        // Adds bounce buffers for transfers no backend can do directly, e.g.,
+        // from a local file to a remote agent. Each descriptor is a buffer,
+        // all of the same length, and they're registered with every backend
+        // created so far that takes their memory type. Later calls add to
+        // the same pool, with the same memory type and length.
+        // When createXferReq isn't given a backend and finds none with both
+        // sides registered, though each side is registered with some
+        // backend, the transfer goes through stagingDepth of these
+        // buffers in chunks of their length: a chunk is moved into a buffer
+        // by a backend that has the source side, and out of it by one that
+        // has the destination side, and the two legs overlap. Such a request
+        // holds its buffers until it's invalidated, and createXferReq
+        // returns NIXL_ERR_NOT_ALLOWED if none are free. The chunks are moved
+        // along by the agent's progress thread if it runs, and by
+        // postXferReq and getXferStatus, and it can't have a signal.
+        nixl_status_t addStagingBuffers (const nixl_reg_dlist_t &buffers);
+
+        // Makes a staged request even if a backend could do it directly,
+        // e.g., reading blocks from a local file with a storage backend and
+        // writing them to a remote agent with a network one, as a single
+        // request with a single status. local_backend moves the chunks
+        // between local_descs and the staging buffers, and remote_backend
+        // between the buffers and remote_descs. Null means any backend that
+        // has both sides of the leg. NIXL_READ goes the other way, from
+        // the remote agent to local_descs.
+        nixl_status_t createXferChain (const nixl_xfer_dlist_t &local_descs,
+                                       const nixl_xfer_dlist_t &remote_descs,
+                                       const std::string &remote_agent,
+                                       const std::string &notif_msg,
+                                       const nixl_xfer_op_t &operation,
+                                       nixlXferReqH* &req_handle,
+                                       const nixlBackendH* local_backend = nullptr,
+                                       const nixlBackendH* remote_backend = nullptr) const;
+
+
         /*** Alternative method to create transfer handle manually ***/
 
         // User can ask for backend chosen for a XferReq to use it for prepXferSide.
+        // Staged transfers use more than one, and give nullptr.
         nixlBackendH* getXferBackend(const nixlXferReqH* req_handle) const;
 
         // Prepares descriptors for one side of a transfer with given backend.
@@ -96,6 +185,19 @@ class nixlAgent {
                                    const nixl_xfer_op_t &operation,
                                    nixlXferReqH* &req_handle) const;
 
+        // Same as above with index arrays, for making requests repeatedly,
+        // e.g., from block tables. If req_handle is not nullptr, it's reused
+        // and its previous transfer and signal released. It should be a
+        // request from makeXferReq, and the same one is returned in req_handle.
+        nixl_status_t makeXferReq (const nixlXferSideH* local_side,
+                                   const int* local_indices,
+                                   const nixlXferSideH* remote_side,
+                                   const int* remote_indices,
+                                   const int &desc_count,
+                                   const std::string &notif_msg,
+                                   const nixl_xfer_op_t &operation,
+                                   nixlXferReqH* &req_handle) const;
+
         void invalidateXferSide (nixlXferSideH* side_handle) const;
 
         /*** Notification Handling ***/
@@ -105,6 +207,18 @@ class nixlAgent {
         // an error. Elements are released within the Agent after this call.
         int getNotifs (nixl_notifs_t &notif_map);
 
+        // Same, appending to the arena instead, which is cleared and reused
+        // by the caller. Messages are copied in place, without allocations
+        // per notification once the arena has grown.
+        int getNotifs (nixlNotifArena &arena);
+
+        // Delivers notifications to cb in batches on the backends' progress
+        // threads, instead of queueing them for getNotifs. Null cb stops it.
+        // The arena is only valid during the call, and cb shouldn't call
+        // setNotifCallback. Needs the progress thread on every backend that
+        // supports notifications, and already queued ones stay queued.
+        nixl_status_t setNotifCallback (nixl_notif_cb_t cb, void* arg);
+
         // Generate a notification, not bound to a transfer, e.g., for control.
         // Can be used after the remote metadata is exchanged. Will be received
         // in notif list. Nixl will choose a backend if null is passed.
@@ -123,8 +237,48 @@ class nixlAgent {
         // Returns the found agent name in metadata, or "" in case of error.
         std::string loadRemoteMD (const std::string &remote_metadata);
 
+        // Same as above, but reads the metadata in place from the caller's
+        // memory, avoiding copies of large metadata blobs.
+        std::string loadRemoteMD (const void* remote_metadata,
+                                  const size_t &len);
+
+        // Load metadata saved to a file (getLocalMD output), which is
+        // memory mapped during the load instead of being read into memory.
+        std::string loadRemoteMDFile (const std::string &file_path);
+
         // Invalidate the remote section information cached locally
         nixl_status_t invalidateRemoteMD (const std::string &remote_agent);
+
+    friend class nixlXferContext;
+};
+
+// Per thread context for creating transfer requests of an agent. It keeps its
+// own view of the agent's memory sections and remote agents, refreshed only
+// when the agent changes them, and a pool of request handles. So in steady
+// state request creation doesn't touch state shared with other threads.
+// A context is used by one thread at a time, and has to outlive its requests.
+class nixlXferContext {
+    private:
+        nixlXferContextData* data;
+
+    public:
+        nixlXferContext (const nixlAgent &agent);
+        ~nixlXferContext ();
+
+        // Same as nixlAgent::createXferReq, except it never falls back to the
+        // agent's staging buffers, which are shared by all threads; use
+        // createXferChain for staged requests. The returned request is posted
+        // and checked through the agent as usual.
+        nixl_status_t createXferReq (const nixl_xfer_dlist_t &local_descs,
+                                     const nixl_xfer_dlist_t &remote_descs,
+                                     const std::string &remote_agent,
+                                     const std::string &notif_msg,
+                                     const nixl_xfer_op_t &operation,
+                                     nixlXferReqH* &req_handle,
+                                     const nixlBackendH* backend = nullptr);
+
+        // Aborts the request if running, and returns it to the pool
+        void releaseXferReq (nixlXferReqH* req);
 };
 
 #endif
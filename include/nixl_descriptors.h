@@ -36,6 +36,7 @@ class nixlBasicDesc {
                       const size_t &len,
                       const uint32_t &dev_id);
         nixlBasicDesc(const std::string &str); // deserializer
+        nixlBasicDesc(const char* buf, const size_t &size); // deserializer
         nixlBasicDesc(const nixlBasicDesc &desc) = default;
         nixlBasicDesc& operator=(const nixlBasicDesc &desc) = default;
         ~nixlBasicDesc() = default;
@@ -63,6 +64,7 @@ class nixlStringDesc : public nixlBasicDesc {
                        const uint32_t &dev_id, const std::string &meta_info);
         nixlStringDesc(const nixlBasicDesc &desc, const std::string &meta_info);
         nixlStringDesc(const std::string &str); // Deserializer
+        nixlStringDesc(const char* buf, const size_t &size); // Deserializer
 
         friend bool operator==(const nixlStringDesc &lhs,
                                const nixlStringDesc &rhs);
@@ -73,6 +75,43 @@ class nixlStringDesc : public nixlBasicDesc {
 };
 
 
+// Strided descriptor, count elements of len bytes each, stride bytes apart
+// from addr on, e.g., a slice of a tensor. It's used in transfer requests
+// instead of one descriptor per element, and expanded only in populate.
+class nixlStridedDesc : public nixlBasicDesc {
+    public:
+        size_t stride;
+        size_t count;
+
+        nixlStridedDesc() {}; // No initialization to zero
+        nixlStridedDesc(const uintptr_t &addr,
+                        const size_t &elem_len,
+                        const size_t &stride,
+                        const size_t &count,
+                        const uint32_t &dev_id);
+        // A contiguous descriptor, as one element
+        explicit nixlStridedDesc(const nixlBasicDesc &desc);
+        nixlStridedDesc(const std::string &str); // deserializer
+        nixlStridedDesc(const char* buf, const size_t &size); // deserializer
+
+        friend bool operator==(const nixlStridedDesc &lhs,
+                               const nixlStridedDesc &rhs);
+        friend bool operator!=(const nixlStridedDesc &lhs,
+                               const nixlStridedDesc &rhs);
+
+        // True if there are elements, and their extent fits the address space
+        bool validExtent() const;
+        // The smallest contiguous descriptor that covers all the elements,
+        // only meaningful if validExtent()
+        nixlBasicDesc extent() const;
+        // True if elements are back to back, so the extent can be used as is
+        inline bool isContiguous() const { return (stride==len) || (count<=1); }
+
+        std::string serialize() const;
+        void print(const std::string &suffix) const;
+};
+
+
 // A class for a list of descriptors, where transfer requests are made from.
 // It has some additional methods to help with creation and population.
 template<class T>
@@ -83,6 +122,8 @@ class nixlDescList {
         bool           sorted;
         std::vector<T> descs;
 
+        void mergeAppended(const size_t &old_size);
+
     public:
         nixlDescList(const nixl_mem_t &type, const bool &unifiedAddr=true,
                      const bool &sorted=false, const int &init_size=0);
@@ -100,6 +141,12 @@ class nixlDescList {
 
         const T& operator[](unsigned int index) const;
         T& operator[](unsigned int index);
+        // Unchecked versions of [] for internal hot loops where the indices
+        // are already validated. The setter does not reset sorted either, so
+        // the caller has to keep the order valid if the list is sorted.
+        inline const T& descAt(unsigned int index) const { return descs[index]; }
+        inline T& descAt(unsigned int index) { return descs[index]; }
+        inline const T* data() const { return descs.data(); }
         inline typename std::vector<T>::const_iterator begin() const
             { return descs.begin(); }
         inline typename std::vector<T>::const_iterator end() const
@@ -116,18 +163,80 @@ class nixlDescList {
         bool verifySorted();
         inline void clear() { descs.clear(); }
         void addDesc(const T &desc); // If sorted, keeps it sorted
+        // Bulk versions, sort/compact once instead of per element
+        void addDescs(const std::vector<T> &new_descs);
+        void addDescs(const nixlDescList<T> &d_list);
         nixl_status_t remDesc(const int &index);
+        nixl_status_t remDescs(const std::vector<int> &indices);
         nixl_status_t populate(const nixlDescList<nixlBasicDesc> &query,
                                nixlDescList<T> &resp) const;
         nixlDescList<nixlBasicDesc> trim() const;
 
         bool overlaps (const T &desc, int &index) const;
         int getIndex(const nixlBasicDesc &query) const;
+        // Index of a descriptor that covers the query, negative if none
+        int getCoverIndex(const nixlBasicDesc &query) const;
         nixl_status_t serialize(nixlSerDes* serializer) const;
         void print() const;
 };
 
 typedef nixlDescList<nixlBasicDesc>  nixl_xfer_dlist_t;
 typedef nixlDescList<nixlStringDesc> nixl_reg_dlist_t;
+typedef nixlDescList<nixlStridedDesc> nixl_strided_dlist_t;
+
+// A notification in a nixlNotifArena. The message is len bytes at offset
+// in the arena's data, sent by the agent named agents[agentId].
+typedef struct {
+    uint32_t agentId;
+    size_t   offset;
+    size_t   len;
+} nixl_notif_rec_t;
+
+// Caller owned storage to receive notifications in batches. Messages are
+// packed back to back in data, and each agent name is kept once. clear()
+// keeps the capacity, so a reused arena stops allocating once it has grown
+// to the batch size. Agent ids stay valid for the life of the arena.
+class nixlNotifArena {
+    private:
+        uint32_t lastId = 0;
+
+    public:
+        std::string                   data;
+        std::vector<nixl_notif_rec_t> recs;
+        std::vector<std::string>      agents;
+
+        inline size_t size() const { return recs.size(); }
+        inline void clear() { data.clear(); recs.clear(); }
+
+        inline const char* msg(const nixl_notif_rec_t &rec) const {
+            return data.data() + rec.offset;
+        }
+
+        // Consecutive messages are mostly from one agent, and agents are
+        // few, so a scan is cheaper than hashing a copy of the name.
+        uint32_t agentId(const char* name, size_t len) {
+            if ((lastId < agents.size()) &&
+                (agents[lastId].compare(0, std::string::npos, name, len) == 0))
+                return lastId;
+            for (lastId = 0; lastId < agents.size(); lastId++)
+                if (agents[lastId].compare(0, std::string::npos, name, len) == 0)
+                    return lastId;
+            agents.emplace_back(name, len);
+            return lastId;
+        }
+
+        void add(const char* agent, size_t agent_len,
+                 const char* msg, size_t len) {
+            nixl_notif_rec_t rec;
+            rec.agentId = agentId(agent, agent_len);
+            rec.offset  = data.size();
+            rec.len     = len;
+            data.append(msg, len);
+            recs.push_back(rec);
+        }
+
+        // Adds the notifications of other after these
+        void append(const nixlNotifArena &other);
+};
 
 #endif
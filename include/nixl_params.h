@@ -40,6 +40,36 @@ class nixlAgentConfig {
          */
         uint64_t pthrDelay;
 
+        // Use compact encoding for descriptor lists in getLocalMD output.
+        // Peers need to support it for loading, default is off.
+        bool     compressMD;
+
+        // Run one progress thread in the agent for all backends, instead of
+        // one in each of them. Only used with useProgThread, default is off.
+        bool     agentProgThread;
+
+        // Core to pin the agent's progress thread to, -1 to not pin it
+        int      pthrCore;
+
+        // When a round finds no work, the agent's progress thread blocks up
+        // to this long (in ms) on the backends' file descriptors, instead of
+        // yielding for pthrDelay. Only if every backend it progresses can be
+        // waited on, and 0 means it never blocks.
+        uint64_t pthrWaitMs;
+
+        // Transfers that fail with a backend error or time out are posted
+        // again, up to this many times per postXferReq. Each retry moves to
+        // another backend with both sides' memory registered, if there's
+        // one, unless the request was made for a given backend. Default 0
+        // returns the error right away.
+        uint32_t xferRetries;
+
+        // Staging buffers a staged transfer holds (see addStagingBuffers),
+        // so how many of its chunks can be between its two legs at once.
+        // Default 2 moves a chunk out of one buffer while the next one
+        // comes into the other.
+        uint32_t stagingDepth;
+
         // std::string defaultLibPath;
 
         // Map from backend_type (e.g., "UCX") to it's lib path
@@ -51,11 +81,18 @@ class nixlAgentConfig {
         nixlAgentConfig(const bool use_prog_thread, const uint64_t pthr_delay_us=0) {
             this->useProgThread = use_prog_thread;
             this->pthrDelay     = pthr_delay_us;
+            this->compressMD    = false;
+            this->agentProgThread = false;
+            this->pthrCore      = -1;
+            this->pthrWaitMs    = 0;
+            this->xferRetries   = 0;
+            this->stagingDepth  = 2;
         }
         nixlAgentConfig(const nixlAgentConfig &cfg) = default;
         ~nixlAgentConfig() = default;
 
     friend class nixlAgent;
+    friend class nixlAgentData;
 };
 
 #endif
@@ -18,6 +18,7 @@
 #define _NIXL_TYPES_H
 #include <vector>
 #include <string>
+#include <cstdint>
 #include <unordered_map>
 
 typedef std::unordered_map<std::string, std::string> nixl_b_params_t;
@@ -41,13 +42,19 @@ typedef enum {
     NIXL_ERR_MISMATCH = -5,
     NIXL_ERR_NOT_ALLOWED = -6,
     NIXL_ERR_REPOST_ACTIVE = -7,
-    NIXL_ERR_UNKNOWN = -8
+    NIXL_ERR_UNKNOWN = -8,
+    NIXL_ERR_TIMEOUT = -9
 } nixl_status_t;
 
 class nixlSerDes;
+class nixlNotifArena;
 class nixlBackendH;
 class nixlXferReqH;
 class nixlXferSideH;
 class nixlAgentData;
+class nixlXferContextData;
+
+// Receives a batch of notifications, see nixlAgent::setNotifCallback
+typedef void (*nixl_notif_cb_t)(const nixlNotifArena &notifs, void* arg);
 
 #endif
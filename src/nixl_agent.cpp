@@ -14,6 +14,15 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include "nixl.h"
 #include "ucx_backend.h"
 #include "utils/serdes/serdes.h"
@@ -28,11 +37,20 @@
 
 nixlAgentData::nixlAgentData(const std::string &name,
                              const nixlAgentConfig &cfg) :
-                             name(name), config(cfg) {}
+                             name(name), config(cfg),
+                             notifCb(nullptr), notifCbArg(nullptr),
+                             localGen(0), remoteGen(0), deadlineCount(0),
+                             stagingMem(DRAM_SEG), chainCount(0) {
+    remoteState = std::make_shared<nixlRemoteState>();
+    progressStart();
+}
 
 nixlAgentData::~nixlAgentData() {
-    for (auto & elm: remoteSections)
-        delete elm.second;
+    // Backends are progressed by the thread until it's stopped
+    progressStop();
+
+    // Sections unload their metadata from the engines, so they go first
+    remoteState.reset();
 
     for (auto & elm: backendEngines) {
         auto& plugin_manager = nixlPluginManager::getInstance();
@@ -48,12 +66,700 @@ nixlAgentData::~nixlAgentData() {
         delete elm.second;
 }
 
+void nixlAgentData::progressStart() {
+    struct epoll_event ev;
+
+    progStop  = false;
+    progWaiting = false;
+    progEpoll = -1;
+    progWake  = -1;
+
+    if (!config.useProgThread || !config.agentProgThread)
+        return;
+
+    if (config.pthrWaitMs) {
+        progEpoll = epoll_create1(EPOLL_CLOEXEC);
+        progWake  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        ev.events   = EPOLLIN;
+        ev.data.ptr = nullptr;
+        if ((progEpoll < 0) || (progWake < 0) ||
+            epoll_ctl(progEpoll, EPOLL_CTL_ADD, progWake, &ev)) {
+            // Fall back to yielding between rounds
+            if (progEpoll >= 0)
+                close(progEpoll);
+            if (progWake >= 0)
+                close(progWake);
+            progEpoll = progWake = -1;
+        }
+    }
+
+    progThread = std::thread(&nixlAgentData::progressFunc, this);
+}
+
+void nixlAgentData::progressStop() {
+    uint64_t one = 1;
+
+    if (!progThread.joinable())
+        return;
+
+    progStop = true;
+    if ((progWake >= 0) && (write(progWake, &one, sizeof(one)) < 0))
+        std::cerr << "Failed to wake the progress thread, it stops on timeout\n";
+    progThread.join();
+
+    if (progEpoll >= 0) {
+        close(progEpoll);
+        close(progWake);
+    }
+}
+
+void nixlAgentData::progressFunc() {
+    std::vector<nixlBackendEngine*> engines;
+    struct epoll_event evs[8];
+    uint64_t gen = 0;
+    bool refresh = true, all_fds = true;
+
+    if (config.pthrCore >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.pthrCore, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus))
+            std::cerr << "Failed to pin the progress thread to core "
+                      << config.pthrCore << "\n";
+    }
+
+    while (!progStop.load(std::memory_order_relaxed)) {
+        if (deadlineCount.load(std::memory_order_relaxed))
+            expireDeadlines();
+
+        // Pick up backends created since the last round
+        uint64_t cur = localGen.load(std::memory_order_acquire);
+        if (refresh || (cur != gen)) {
+            nixlSharedGuard guard(localLock);
+            for (auto & eng: backendEngines) {
+                nixlBackendEngine* engine = eng.second;
+                if (!engine->supportsProgTh())
+                    continue;
+                if (std::find(engines.begin(), engines.end(), engine) == engines.end()) {
+                    engine->pthrAttach();
+                    engines.push_back(engine);
+                    if (progEpoll >= 0) {
+                        struct epoll_event ev;
+                        int fd = engine->pthrFd();
+                        ev.events   = EPOLLIN;
+                        ev.data.ptr = engine;
+                        if ((fd < 0) || epoll_ctl(progEpoll, EPOLL_CTL_ADD, fd, &ev))
+                            all_fds = false;
+                    }
+                }
+            }
+            gen = cur;
+            refresh = false;
+        }
+
+        int work = 0;
+        for (auto & engine: engines) {
+            work += engine->pthrRound();
+            dropFailedPeers(engine);
+        }
+
+        // Legs may be on backends that don't wake us up, so no blocking
+        // while staged requests run
+        bool chained = chainCount.load(std::memory_order_relaxed);
+        if (chained)
+            progressChains();
+        if (work)
+            continue;
+
+        if ((progEpoll >= 0) && all_fds && !chained) {
+            bool armed = true;
+            for (auto & engine: engines) {
+                if (!engine->pthrArm()) {
+                    armed = false;
+                    break;
+                }
+            }
+            if (!armed)
+                continue;
+
+            // Set before looking at deadlines, so setDeadline wakes us up
+            // for an earlier one added after that
+            progWaiting = true;
+            int timeout = (int) config.pthrWaitMs;
+            int next_ms = expireDeadlines();
+            if ((next_ms >= 0) && (next_ms < timeout))
+                timeout = next_ms;
+            if (epoll_wait(progEpoll, evs, 8, timeout) > 0) {
+                uint64_t val;
+                ssize_t ret = read(progWake, &val, sizeof(val));
+                (void) ret;
+            }
+            progWaiting = false;
+            continue;
+        }
+
+        // Same as the backends' own threads
+        nixlTime::us_t start = nixlTime::getUs();
+        while ((start + config.pthrDelay) > nixlTime::getUs())
+            std::this_thread::yield();
+    }
+}
+
+nixl_status_t nixlAgentData::invalidateRemote(const std::string &remote_agent) {
+    std::shared_ptr<nixlRemoteState> state =
+                        std::make_shared<nixlRemoteState>(*getRemote());
+
+    backend_set_t backends;
+    auto b_itr = state->backends.find(remote_agent);
+    if (b_itr != state->backends.end()) {
+        backends = b_itr->second;
+        state->backends.erase(b_itr);
+    }
+
+    // Requests and side handles that use the section keep it alive,
+    // otherwise it's freed here, before disconnecting.
+    if ((state->sections.erase(remote_agent) == 0) && backends.empty())
+        return NIXL_ERR_NOT_FOUND;
+    setRemote(state);
+
+    for (auto & elm: backends)
+        backendEngines[elm]->disconnect(remote_agent);
+
+    return NIXL_SUCCESS;
+}
+
+void nixlAgentData::dropFailedPeers(nixlBackendEngine* engine) {
+    std::vector<std::string> failed;
+
+    engine->getFailedConns(failed);
+    if (failed.empty())
+        return;
+
+    std::lock_guard<std::mutex> guard(ctrlLock);
+    for (auto & remote_agent: failed) {
+        if (remote_agent != name)
+            invalidateRemote(remote_agent);
+    }
+}
+
+void nixlAgentData::setDeadline(nixlXferReqH* req, uint64_t deadline) {
+    req->deadline = deadline;
+    req->expired  = false;
+    if (!progThread.joinable())
+        return;
+
+    uint64_t one = 1;
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(deadlineLock);
+        req->deadlineIt     = deadlines.emplace(deadline, req);
+        req->deadlineQueued = true;
+        deadlineCount++;
+        first = (req->deadlineIt == deadlines.begin());
+    }
+
+    // The progress thread may be waiting past it
+    if (first && progWaiting && (write(progWake, &one, sizeof(one)) < 0))
+        std::cerr << "Failed to wake the progress thread for a deadline\n";
+}
+
+void nixlAgentData::clearDeadline(nixlXferReqH* req) {
+    if (req->deadlineQueued) {
+        std::lock_guard<std::mutex> lock(deadlineLock);
+        // Expired ones were already removed by the progress thread
+        if (!req->expired) {
+            deadlines.erase(req->deadlineIt);
+            deadlineCount--;
+        }
+        req->deadlineQueued = false;
+    }
+    req->deadline = 0;
+}
+
+bool nixlAgentData::deadlinePassed(nixlXferReqH* req) {
+    if (req->deadlineQueued)
+        return req->expired.load(std::memory_order_acquire);
+    return nixlTime::getUs() >= req->deadline;
+}
+
+int nixlAgentData::expireDeadlines() {
+    nixlTime::us_t now = nixlTime::getUs();
+
+    std::lock_guard<std::mutex> lock(deadlineLock);
+    auto it = deadlines.begin();
+    while ((it != deadlines.end()) && (it->first <= now)) {
+        it->second->expired.store(true, std::memory_order_release);
+        it = deadlines.erase(it);
+        deadlineCount--;
+    }
+
+    if (it == deadlines.end())
+        return -1;
+    return (it->first - now + 999) / 1000;
+}
+
+void nixlAgentData::stopXfer(nixlXferReqH* req) {
+    clearDeadline(req);
+    if (req->backendHandle != nullptr) {
+        req->engine->releaseReqH(req->backendHandle);
+        req->backendHandle = nullptr;
+    }
+}
+
+nixl_status_t nixlAgentData::postXfer(nixlXferReqH* req) {
+    nixl_status_t ret;
+
+    stopXfer(req);
+
+    if (req->signalDescs != nullptr)
+        ret = (req->engine->postXferSignal (*req->initiatorDescs,
+                                             *req->targetDescs,
+                                             req->backendOp,
+                                             req->remoteAgent,
+                                             req->notifMsg,
+                                             (*req->signalDescs)[0],
+                                             req->backendHandle));
+    else
+        ret = (req->engine->postXfer (*req->initiatorDescs,
+                                       *req->targetDescs,
+                                       req->backendOp,
+                                       req->remoteAgent,
+                                       req->notifMsg,
+                                       req->backendHandle));
+    if (req->timeoutUs && (ret == NIXL_IN_PROG))
+        setDeadline(req, nixlTime::getUs() + req->timeoutUs);
+    return ret;
+}
+
+nixl_status_t nixlAgentData::retryXfer(nixlXferReqH* req, nixl_status_t ret) {
+    // Other errors are in the request itself, and would fail again
+    while (((ret == NIXL_ERR_BACKEND) || (ret == NIXL_ERR_TIMEOUT)) &&
+           (req->retriesLeft > 0)) {
+        req->retriesLeft--;
+        // The failed handle goes back to the engine that made it, before
+        // failover can change the engine and free the lists it uses
+        stopXfer(req);
+        if (req->failover)
+            failoverXfer(req);
+        ret = postXfer(req);
+    }
+    return ret;
+}
+
+bool nixlAgentData::failoverXfer(nixlXferReqH* req) {
+    nixl_meta_dlist_t &descs = *req->initiatorDescs;
+    nixl_meta_dlist_t &rdescs = *req->targetDescs;
+
+    // Populated descriptors keep what's needed to look them up again
+    nixl_xfer_dlist_t local(descs.getType(), descs.isUnifiedAddr(), descs.isSorted());
+    nixl_xfer_dlist_t remote(rdescs.getType(), rdescs.isUnifiedAddr(), rdescs.isSorted());
+    for (int i = 0; i < descs.descCount(); i++) {
+        local.addDesc((nixlBasicDesc) descs[i]);
+        remote.addDesc((nixlBasicDesc) rdescs[i]);
+    }
+    nixl_xfer_dlist_t counter(DRAM_SEG, true, true);
+    if (req->signalDescs != nullptr)
+        counter.addDesc((nixlBasicDesc) (*req->signalDescs)[0]);
+
+    remote_state_ptr_t state = getRemote();
+    auto s_itr = state->sections.find(req->remoteAgent);
+    if (s_itr == state->sections.end())
+        return false;
+
+    nixlSharedGuard guard(localLock);
+    return selectBackend(req, local, remote, counter, s_itr->second);
+}
+
+bool nixlAgentData::selectBackend(nixlXferReqH* req,
+                                  const nixl_xfer_dlist_t &local,
+                                  const nixl_xfer_dlist_t &remote,
+                                  const nixl_xfer_dlist_t &counter,
+                                  const remote_section_ptr_t &section,
+                                  const nixlBackendEngine* only) {
+    bool is_local = (req->remoteAgent == name);
+    bool signal   = (counter.descCount() > 0);
+
+    for (auto & elm: backendEngines) {
+        nixlBackendEngine* engine = elm.second;
+        if ((engine == req->engine) || (only && (engine != only)) ||
+            (is_local ? !engine->supportsLocal() : !engine->supportsRemote()) ||
+            (!req->notifMsg.empty() && !engine->supportsNotif()) ||
+            (signal && !engine->supportsSignal()))
+            continue;
+
+        nixl_meta_dlist_t* ldescs = new nixl_meta_dlist_t(local.getType(),
+                                        local.isUnifiedAddr(), local.isSorted());
+        nixl_meta_dlist_t* tdescs = new nixl_meta_dlist_t(remote.getType(),
+                                        remote.isUnifiedAddr(), remote.isSorted());
+        nixl_meta_dlist_t* sdescs = nullptr;
+        nixl_status_t ret = memorySection.populate(local, elm.first, *ldescs);
+        if (ret == NIXL_SUCCESS)
+            ret = section->populate(remote, elm.first, *tdescs);
+        if ((ret == NIXL_SUCCESS) && signal) {
+            sdescs = new nixl_meta_dlist_t(DRAM_SEG, true, true);
+            ret = section->populate(counter, elm.first, *sdescs);
+        }
+        if (ret != NIXL_SUCCESS) {
+            delete ldescs;
+            delete tdescs;
+            delete sdescs;
+            continue;
+        }
+
+        // Callers stopped the previous transfer, nothing uses the old lists
+        delete req->initiatorDescs;
+        delete req->targetDescs;
+        req->initiatorDescs = ldescs;
+        req->targetDescs    = tdescs;
+        if (sdescs != nullptr) {
+            delete req->signalDescs;
+            req->signalDescs   = sdescs;
+            req->signalSection = section;
+        }
+        req->remoteSection = section;
+        req->engine        = engine;
+        return true;
+    }
+    return false;
+}
+
+nixl_status_t nixlAgentData::submitXfer(nixlXferReqH* req, uint64_t timeout_us) {
+    // We can't repost while a request is in progress, it keeps running
+    if (req->status == NIXL_IN_PROG) {
+        req->status = req->engine->checkXfer(req->backendHandle);
+        if (req->status == NIXL_IN_PROG)
+            return NIXL_ERR_REPOST_ACTIVE;
+    }
+
+    // If status is not NIXL_IN_PROG we can repost, the previous handle is done
+    req->timeoutUs   = timeout_us;
+    req->retriesLeft = config.xferRetries;
+    req->status = retryXfer(req, postXfer(req));
+    return req->status;
+}
+
+nixl_status_t nixlAgentData::xferStatus(nixlXferReqH* req) {
+    // If the transfer has ended, no need to recheck. Completion wins over
+    // a deadline that passed since the last check.
+    if (req->status == NIXL_IN_PROG) {
+        req->status = req->engine->checkXfer(req->backendHandle);
+        // The remote agent may have died, its metadata is dropped then
+        if (req->status < 0)
+            dropFailedPeers(req->engine);
+        if (req->deadline) {
+            if (req->status != NIXL_IN_PROG) {
+                clearDeadline(req);
+            } else if (deadlinePassed(req)) {
+                stopXfer(req);
+                req->status = NIXL_ERR_TIMEOUT;
+            }
+        }
+        if (req->retriesLeft > 0)
+            req->status = retryXfer(req, req->status);
+    }
+
+    return req->status;
+}
+
+bool nixlAgentData::coveredApart(const nixl_xfer_dlist_t &local,
+                                 const nixl_xfer_dlist_t &remote,
+                                 const std::string &remote_agent) {
+    static const backend_set_t no_backends;
+    nixl_meta_dlist_t resp(local.getType(), local.isUnifiedAddr(), false);
+
+    remote_state_ptr_t state = getRemote();
+    auto s_itr = state->sections.find(remote_agent);
+    if (s_itr == state->sections.end())
+        return false;
+
+    {
+        nixlSharedGuard guard(localLock);
+        if (memorySection.findQuery(local, remote.getType(), no_backends,
+                                    resp) == nullptr)
+            return false;
+    }
+
+    // Only the lookup of the base section, nothing is loaded for it
+    nixl_meta_dlist_t r_resp(remote.getType(), remote.isUnifiedAddr(), false);
+    return (s_itr->second->findQuery(remote, local.getType(), no_backends,
+                                     r_resp) != nullptr);
+}
+
+nixlXferReqH* nixlAgentData::createLeg(const nixl_xfer_dlist_t &staging,
+                                       const nixl_xfer_dlist_t &other,
+                                       const std::string &remote_agent,
+                                       const std::string &notif_msg,
+                                       const nixl_xfer_op_t &operation,
+                                       const nixlBackendH* backend) {
+    static const nixl_xfer_dlist_t no_counter(DRAM_SEG, true, true);
+
+    remote_state_ptr_t state = getRemote();
+    auto s_itr = state->sections.find(remote_agent);
+    if (s_itr == state->sections.end())
+        return nullptr;
+
+    nixlXferReqH* leg = new nixlXferReqH;
+    leg->remoteAgent = remote_agent;
+    leg->notifMsg    = notif_msg;
+    leg->backendOp   = operation;
+    leg->status      = NIXL_ERR_NOT_POSTED;
+    leg->failover    = true;
+
+    nixlSharedGuard guard(localLock);
+    if (!selectBackend(leg, staging, other, no_counter, s_itr->second,
+                       backend ? backend->engine : nullptr)) {
+        delete leg;
+        return nullptr;
+    }
+    return leg;
+}
+
+nixl_status_t nixlAgentData::createStaged(const nixl_xfer_dlist_t &local_descs,
+                                          const nixl_xfer_dlist_t &remote_descs,
+                                          const std::string &remote_agent,
+                                          const std::string &notif_msg,
+                                          const nixl_xfer_op_t &operation,
+                                          const nixlBackendH* local_backend,
+                                          const nixlBackendH* remote_backend,
+                                          nixlXferReqH* &req_handle) {
+    bool is_read = (operation == NIXL_READ) || (operation == NIXL_RD_NOTIF);
+    nixlStagedXfer* st = new nixlStagedXfer;
+    std::vector<nixlBasicDesc> bufs;
+    size_t total = 0, slot_len;
+    nixl_mem_t staging_mem;
+
+    for (auto & desc : local_descs)
+        total += desc.len;
+
+    // Buffers are taken for the request's lifetime, so it can't block
+    // another one halfway through
+    {
+        std::lock_guard<std::mutex> guard(stagingLock);
+        if (stagingBufs.empty()) {
+            delete st;
+            return NIXL_ERR_NOT_FOUND;
+        }
+        slot_len = stagingBufs[0].len;
+        size_t want = std::min<size_t>(config.stagingDepth,
+                                       (total + slot_len - 1) / slot_len);
+        want = std::max<size_t>(want, 1);
+        while ((st->slots.size() < want) && !stagingFree.empty()) {
+            st->slots.push_back(stagingFree.back());
+            bufs.push_back(stagingBufs[stagingFree.back()]);
+            stagingFree.pop_back();
+        }
+        staging_mem = stagingMem;
+    }
+    if (st->slots.empty()) {
+        delete st;
+        return NIXL_ERR_NOT_ALLOWED;
+    }
+
+    st->remoteLeg = is_read ? 0 : 1;
+    st->notif     = (operation == NIXL_WR_NOTIF) || (operation == NIXL_RD_NOTIF);
+
+    // Descriptors are split at buffer boundaries, and packed back to back
+    // in a buffer, so small ones share a chunk
+    nixl_xfer_dlist_t staging(staging_mem, true, false);
+    nixl_xfer_dlist_t local(local_descs.getType(), local_descs.isUnifiedAddr(), false);
+    nixl_xfer_dlist_t remote(remote_descs.getType(), remote_descs.isUnifiedAddr(), false);
+    size_t offset = 0, filled = 0;
+    int i = 0;
+    nixl_status_t ret = NIXL_SUCCESS;
+
+    while (ret == NIXL_SUCCESS) {
+        if (i < local_descs.descCount()) {
+            const nixlBasicDesc &l_desc = local_descs[i];
+            const nixlBasicDesc &r_desc = remote_descs[i];
+            const nixlBasicDesc &buf = bufs[st->chunks.size() % bufs.size()];
+            size_t len = std::min(l_desc.len - offset, slot_len - filled);
+
+            staging.addDesc(nixlBasicDesc(buf.addr + filled, len, buf.devId));
+            local.addDesc(nixlBasicDesc(l_desc.addr + offset, len, l_desc.devId));
+            remote.addDesc(nixlBasicDesc(r_desc.addr + offset, len, r_desc.devId));
+            filled += len;
+            offset += len;
+            if (offset == l_desc.len) {
+                offset = 0;
+                i++;
+            }
+            if (filled < slot_len)
+                continue;
+        }
+        if (filled == 0)
+            break;
+
+        // Through the buffer: the source is read into it, and it's written
+        // to the destination. Only the leg to the remote agent notifies.
+        bool notify = st->notif && (i == local_descs.descCount());
+        nixlStagedXfer::chunk c;
+        if (is_read) {
+            c.legs[0] = createLeg(staging, remote, remote_agent,
+                                  notify ? notif_msg : "",
+                                  notify ? NIXL_RD_NOTIF : NIXL_READ,
+                                  remote_backend);
+            c.legs[1] = createLeg(staging, local, name, "", NIXL_WRITE,
+                                  local_backend);
+        } else {
+            c.legs[0] = createLeg(staging, local, name, "", NIXL_READ,
+                                  local_backend);
+            c.legs[1] = createLeg(staging, remote, remote_agent,
+                                  notify ? notif_msg : "",
+                                  notify ? NIXL_WR_NOTIF : NIXL_WRITE,
+                                  remote_backend);
+        }
+        st->chunks.push_back(c);
+        if ((c.legs[0] == nullptr) || (c.legs[1] == nullptr))
+            ret = NIXL_ERR_NOT_FOUND;
+
+        staging.clear();
+        local.clear();
+        remote.clear();
+        filled = 0;
+    }
+
+    if (ret != NIXL_SUCCESS) {
+        releaseStaged(st);
+        delete st;
+        return ret;
+    }
+
+    nixlXferReqH *handle = new nixlXferReqH;
+    handle->staged      = st;
+    handle->remoteAgent = remote_agent;
+    handle->notifMsg    = notif_msg;
+    handle->backendOp   = operation;
+    handle->status      = NIXL_ERR_NOT_POSTED;
+    req_handle = handle;
+    return NIXL_SUCCESS;
+}
+
+void nixlAgentData::stopStaged(nixlStagedXfer* st) {
+    for (int l = 0; l < 2; l++)
+        for (size_t i = st->done[l]; i < st->posted[l]; i++) {
+            stopXfer(st->chunks[i].legs[l]);
+            st->chunks[i].legs[l]->status = NIXL_ERR_NOT_POSTED;
+        }
+    st->posted[0] = st->posted[1] = 0;
+    st->done[0]   = st->done[1]   = 0;
+}
+
+nixl_status_t nixlAgentData::progressStaged(nixlStagedXfer* st) {
+    size_t count = st->chunks.size();
+    size_t depth = st->slots.size();
+    bool moved = true;
+
+    while (moved) {
+        moved = false;
+
+        for (int l = 0; l < 2; l++) {
+            while (st->done[l] < st->posted[l]) {
+                nixl_status_t ret = xferStatus(st->chunks[st->done[l]].legs[l]);
+                if (ret == NIXL_IN_PROG)
+                    break;
+                if (ret < 0) {
+                    stopStaged(st);
+                    return ret;
+                }
+                st->done[l]++;
+                moved = true;
+            }
+        }
+        if (st->done[1] == count)
+            return NIXL_SUCCESS;
+
+        // A chunk goes out once it's in its buffer, and the next chunk for
+        // the buffer comes in once it's out
+        for (int l = 1; l >= 0; l--) {
+            size_t limit = (l == 1) ? st->done[0] :
+                           std::min(count, st->done[1] + depth);
+            while (st->posted[l] < limit) {
+                if (st->notif && (l == st->remoteLeg) &&
+                    (st->posted[l] == count - 1) && (st->done[l] < count - 1))
+                    break;
+                nixlXferReqH* leg = st->chunks[st->posted[l]].legs[l];
+                nixl_status_t ret = submitXfer(leg, 0);
+                if (ret < 0) {
+                    stopStaged(st);
+                    return ret;
+                }
+                st->posted[l]++;
+                moved = true;
+            }
+        }
+    }
+
+    if (st->deadline && (nixlTime::getUs() >= st->deadline)) {
+        stopStaged(st);
+        return NIXL_ERR_TIMEOUT;
+    }
+    return NIXL_IN_PROG;
+}
+
+void nixlAgentData::releaseStaged(nixlStagedXfer* st) {
+    stopStaged(st);
+    std::lock_guard<std::mutex> guard(stagingLock);
+    stagingFree.insert(stagingFree.end(), st->slots.begin(), st->slots.end());
+    st->slots.clear();
+}
+
+void nixlAgentData::trackStaged(nixlStagedXfer* st) {
+    if (!progThread.joinable())
+        return;
+
+    std::lock_guard<std::mutex> guard(chainLock);
+    if (std::find(chains.begin(), chains.end(), st) == chains.end()) {
+        chains.push_back(st);
+        chainCount++;
+    }
+}
+
+void nixlAgentData::untrackStaged(nixlStagedXfer* st) {
+    std::lock_guard<std::mutex> guard(chainLock);
+    auto it = std::find(chains.begin(), chains.end(), st);
+    if (it != chains.end()) {
+        chains.erase(it);
+        chainCount--;
+    }
+}
+
+void nixlAgentData::progressChains() {
+    std::lock_guard<std::mutex> guard(chainLock);
+    auto it = chains.begin();
+    while (it != chains.end()) {
+        // Its thread is moving it along already
+        std::unique_lock<std::mutex> lock((*it)->lock, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            ++it;
+            continue;
+        }
+
+        if ((*it)->status == NIXL_IN_PROG)
+            (*it)->status = progressStaged(*it);
+        if ((*it)->status != NIXL_IN_PROG) {
+            lock.unlock();
+            it = chains.erase(it);
+            chainCount--;
+        } else {
+            ++it;
+        }
+    }
+}
+
 nixlAgent::nixlAgent(const std::string &name,
                      const nixlAgentConfig &cfg) {
     data = new nixlAgentData(name, cfg);
 }
 
 nixlAgent::~nixlAgent() {
+    // Staging buffers were registered by the agent, so it deregisters them
+    if (!data->stagingBufs.empty()) {
+        nixl_reg_dlist_t bufs(data->stagingMem);
+        for (auto & buf : data->stagingBufs)
+            bufs.addDesc(nixlStringDesc(buf, ""));
+        for (auto & backend : data->stagingBackends)
+            deregisterMem(bufs, backend);
+    }
     delete data;
 }
 
@@ -74,6 +780,7 @@ nixl_b_params_t nixlAgent::getBackendOptions (const nixl_backend_t &type) {
     if (plugin_handle) {
         params = plugin_handle->getBackendOptions();
         // We don't keep the plugin loaded if we didn't have it before
+        nixlSharedGuard guard(data->localLock);
         if (data->backendEngines.count(type) == 0) {
             plugin_manager.unloadPlugin(type);
         }
@@ -92,6 +799,9 @@ nixlBackendH* nixlAgent::createBackend(const nixl_backend_t &type,
     nixl_status_t ret;
     std::string str;
 
+    std::lock_guard<std::mutex> ctrl_guard(data->ctrlLock);
+    std::lock_guard<nixlRWLock> guard(data->localLock);
+
     // Registering same type of backend is not supported, unlikely and prob error
     if (data->backendEngines.count(type)!=0)
         return nullptr;
@@ -101,6 +811,9 @@ nixlBackendH* nixlAgent::createBackend(const nixl_backend_t &type,
     init_params.customParams = const_cast<nixl_b_params_t*>(&params);
     init_params.enableProgTh = data->config.useProgThread;
     init_params.pthrDelay    = data->config.pthrDelay;
+    init_params.agentProgTh  = data->config.agentProgThread;
+    init_params.pthrWait     = data->config.agentProgThread &&
+                               (data->config.pthrWaitMs != 0);
 
     // First, try to load the backend as a plugin
     auto& plugin_manager = nixlPluginManager::getInstance();
@@ -139,6 +852,15 @@ nixlBackendH* nixlAgent::createBackend(const nixl_backend_t &type,
             }
         }
 
+        if (data->notifCb && backend->supportsNotif()) {
+            ret = backend->setNotifCallback(data->notifCb, data->notifCbArg);
+
+            if (NIXL_SUCCESS != ret) {
+                delete backend;
+                return nullptr;
+            }
+        }
+
         handle = new nixlBackendH(backend);
         if (handle == nullptr) {
             delete backend;
@@ -148,8 +870,9 @@ nixlBackendH* nixlAgent::createBackend(const nixl_backend_t &type,
         data->backendEngines[type] = backend;
         data->memorySection.addBackendHandler(backend);
         data->backendHandles[type] = handle;
+        data->localChanged();
 
-        // TODO: Check if backend supports ProgThread when threading is in agent
+        // The agent's progress thread picks it up through localGen
     }
 
     return handle; // nullptr in case of error
@@ -159,20 +882,41 @@ nixl_status_t nixlAgent::registerMem(const nixl_reg_dlist_t &descs,
                                      nixlBackendH* backend) {
     nixl_status_t ret;
     nixl_meta_dlist_t remote_self(descs.getType(), descs.isUnifiedAddr(), false);
-    ret = data->memorySection.addDescList(descs, backend->engine, remote_self);
-    if (ret!=NIXL_SUCCESS)
-        return ret;
 
-    if (backend->supportsLocal()) {
-        if (data->remoteSections.count(data->name)==0)
-            data->remoteSections[data->name] = new nixlRemoteSection(
-                                data->name, data->backendEngines);
+    std::lock_guard<std::mutex> ctrl_guard(data->ctrlLock);
+    {
+        std::lock_guard<nixlRWLock> guard(data->localLock);
+        ret = data->memorySection.addDescList(descs, backend->engine, remote_self);
+        data->localChanged();
+    }
+    if ((ret!=NIXL_SUCCESS) || (!backend->supportsLocal()))
+        return ret;
 
-        ret = data->remoteSections[data->name]->loadLocalData(remote_self,
-                                                              backend->engine);
+    // The self section might be in use by other threads, so a copy with
+    // the new descriptors replaces it
+    remote_state_ptr_t old_state = data->getRemote();
+    std::shared_ptr<nixlRemoteState> state =
+                            std::make_shared<nixlRemoteState>(*old_state);
+    remote_section_ptr_t prev, self;
+
+    auto it = state->sections.find(data->name);
+    if (it == state->sections.end()) {
+        self = std::make_shared<nixlRemoteSection>(data->name,
+                                                   data->backendEngines);
+    } else {
+        prev = it->second;
+        self = std::make_shared<nixlRemoteSection>(prev.get());
     }
 
-    return ret;
+    ret = self->loadLocalData(remote_self, backend->engine);
+    if (ret!=NIXL_SUCCESS)
+        return ret;
+
+    state->sections[data->name] = self;
+    if (prev)
+        prev->disownMD();
+    data->setRemote(state);
+    return NIXL_SUCCESS;
 }
 
 nixl_status_t nixlAgent::deregisterMem(const nixl_reg_dlist_t &descs,
@@ -182,11 +926,65 @@ nixl_status_t nixlAgent::deregisterMem(const nixl_reg_dlist_t &descs,
                            descs.isUnifiedAddr(),
                            descs.isSorted());
     nixl_xfer_dlist_t trimmed = descs.trim();
+    std::lock_guard<nixlRWLock> guard(data->localLock);
     // TODO: can use getIndex for exact match instead of populate
     ret = data->memorySection.populate(trimmed, backend->getType(), resp);
     if (ret != NIXL_SUCCESS)
         return ret;
-    return (data->memorySection.remDescList(resp, backend->engine));
+    ret = data->memorySection.remDescList(resp, backend->engine);
+    data->localChanged();
+    return ret;
+}
+
+nixl_status_t nixlAgent::addStagingBuffers(const nixl_reg_dlist_t &buffers) {
+    if (buffers.descCount() == 0)
+        return NIXL_ERR_INVALID_PARAM;
+    for (auto & buf : buffers)
+        if ((buf.len == 0) || (buf.len != buffers[0].len))
+            return NIXL_ERR_INVALID_PARAM;
+
+    std::vector<nixlBackendH*> backends;
+    {
+        std::lock_guard<std::mutex> guard(data->stagingLock);
+        if (!data->stagingBufs.empty() &&
+            ((data->stagingMem != buffers.getType()) ||
+             (data->stagingBufs[0].len != buffers[0].len)))
+            return NIXL_ERR_INVALID_PARAM;
+        backends = data->stagingBackends;
+    }
+
+    // The first buffers go to every backend that takes them, and later ones
+    // to the same backends, so all are usable the same way
+    bool first = backends.empty();
+    if (first) {
+        nixlSharedGuard guard(data->localLock);
+        for (auto & elm : data->backendHandles)
+            backends.push_back(elm.second);
+    }
+
+    std::vector<nixlBackendH*> registered;
+    for (auto & backend : backends) {
+        if (registerMem(buffers, backend) == NIXL_SUCCESS)
+            registered.push_back(backend);
+        else if (!first)
+            break;
+    }
+    if (registered.empty() || (!first && (registered.size() != backends.size()))) {
+        for (auto & backend : registered)
+            deregisterMem(buffers, backend);
+        return NIXL_ERR_BACKEND;
+    }
+
+    std::lock_guard<std::mutex> guard(data->stagingLock);
+    if (data->stagingBufs.empty()) {
+        data->stagingMem      = buffers.getType();
+        data->stagingBackends = registered;
+    }
+    for (auto & buf : buffers) {
+        data->stagingFree.push_back(data->stagingBufs.size());
+        data->stagingBufs.push_back(buf);
+    }
+    return NIXL_SUCCESS;
 }
 
 nixl_status_t nixlAgent::makeConnection(const std::string &remote_agent) {
@@ -194,11 +992,14 @@ nixl_status_t nixlAgent::makeConnection(const std::string &remote_agent) {
     nixl_status_t ret;
     int count = 0;
 
-    if (data->remoteBackends.count(remote_agent)==0)
+    remote_state_ptr_t state = data->getRemote();
+    auto b_itr = state->backends.find(remote_agent);
+    if (b_itr == state->backends.end())
         return NIXL_ERR_NOT_FOUND;
 
+    nixlSharedGuard guard(data->localLock);
     // For now making all the possible connections, later might take hints
-    for (auto & r_eng: data->remoteBackends[remote_agent]) {
+    for (auto & r_eng: b_itr->second) {
         if (data->backendEngines.count(r_eng)!=0) {
             eng = data->backendEngines[r_eng];
             ret = eng->connect(remote_agent);
@@ -208,11 +1009,124 @@ nixl_status_t nixlAgent::makeConnection(const std::string &remote_agent) {
         }
     }
 
-    if (count == 0) // No common backend
-        return NIXL_ERR_BACKEND;
+    if (count == 0) // No common backend
+        return NIXL_ERR_BACKEND;
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t nixlAgent::makeConnectionAsync(const std::string &remote_agent) {
+    nixlBackendEngine* eng;
+    nixl_status_t ret, out_ret = NIXL_SUCCESS;
+    int count = 0;
+
+    remote_state_ptr_t state = data->getRemote();
+    auto b_itr = state->backends.find(remote_agent);
+    if (b_itr == state->backends.end())
+        return NIXL_ERR_NOT_FOUND;
+
+    nixlSharedGuard guard(data->localLock);
+    for (auto & r_eng: b_itr->second) {
+        if (data->backendEngines.count(r_eng)!=0) {
+            eng = data->backendEngines[r_eng];
+            ret = eng->connectAsync(remote_agent);
+            if (ret < 0)
+                return ret;
+            if (ret == NIXL_IN_PROG)
+                out_ret = NIXL_IN_PROG;
+            count++;
+        }
+    }
+
+    if (count == 0) // No common backend
+        return NIXL_ERR_BACKEND;
+    return out_ret;
+}
+
+nixl_status_t nixlAgent::checkConnection(const std::string &remote_agent) {
+    nixlBackendEngine* eng;
+    nixl_status_t ret, out_ret = NIXL_SUCCESS;
+    int count = 0;
+
+    remote_state_ptr_t state = data->getRemote();
+    auto b_itr = state->backends.find(remote_agent);
+    if (b_itr == state->backends.end())
+        return NIXL_ERR_NOT_FOUND;
+
+    nixlSharedGuard guard(data->localLock);
+    for (auto & r_eng: b_itr->second) {
+        if (data->backendEngines.count(r_eng)!=0) {
+            eng = data->backendEngines[r_eng];
+            ret = eng->checkConnect(remote_agent);
+            if (ret < 0)
+                return ret;
+            if (ret == NIXL_IN_PROG)
+                out_ret = NIXL_IN_PROG;
+            count++;
+        }
+    }
+
+    if (count == 0) // No common backend
+        return NIXL_ERR_BACKEND;
+    return out_ret;
+}
+
+// Checks of createXferReq arguments that don't need any agent state
+static nixl_status_t checkXferArgs(const nixl_xfer_dlist_t &local_descs,
+                                   const nixl_xfer_dlist_t &remote_descs,
+                                   const std::string &notif_msg,
+                                   const nixl_xfer_op_t &operation) {
+    // Check the correspondence between descriptor lists
+    if (local_descs.descCount() != remote_descs.descCount())
+        return NIXL_ERR_INVALID_PARAM;
+    auto r_itr = remote_descs.begin();
+    for (auto l_itr = local_descs.begin(); l_itr != local_descs.end(); ++l_itr, ++r_itr)
+        if (l_itr->len != r_itr->len)
+            return NIXL_ERR_INVALID_PARAM;
+
+    if ((notif_msg.size()==0) &&
+        ((operation==NIXL_WR_NOTIF) || (operation==NIXL_RD_NOTIF)))
+        return NIXL_ERR_INVALID_PARAM;
+
+    return NIXL_SUCCESS;
+}
+
+// Strided descriptors are expanded pairwise, so need the same element length
+// and count on both sides, while strides can differ. Each needs elements
+// and an extent that doesn't wrap, and the expanded list has to fit an int.
+static nixl_status_t checkXferArgs(const nixl_strided_dlist_t &local_descs,
+                                   const nixl_strided_dlist_t &remote_descs,
+                                   const std::string &notif_msg,
+                                   const nixl_xfer_op_t &operation) {
+    size_t total = 0;
+
+    if (local_descs.descCount() != remote_descs.descCount())
+        return NIXL_ERR_INVALID_PARAM;
+    auto r_itr = remote_descs.begin();
+    for (auto l_itr = local_descs.begin(); l_itr != local_descs.end(); ++l_itr, ++r_itr) {
+        if ((l_itr->len != r_itr->len) || (l_itr->count != r_itr->count))
+            return NIXL_ERR_INVALID_PARAM;
+        if (!l_itr->validExtent() || !r_itr->validExtent() ||
+            (l_itr->count > (size_t) INT_MAX - total))
+            return NIXL_ERR_INVALID_PARAM;
+        total += l_itr->count;
+    }
+
+    if ((notif_msg.size()==0) &&
+        ((operation==NIXL_WR_NOTIF) || (operation==NIXL_RD_NOTIF)))
+        return NIXL_ERR_INVALID_PARAM;
+
     return NIXL_SUCCESS;
 }
 
+// Populated strided descriptors are not in order anymore
+static inline bool respSorted(const nixl_xfer_dlist_t &query) {
+    return query.isSorted();
+}
+
+static inline bool respSorted(const nixl_strided_dlist_t &query) {
+    return false;
+}
+
 nixl_status_t nixlAgent::createXferReq(const nixl_xfer_dlist_t &local_descs,
                                        const nixl_xfer_dlist_t &remote_descs,
                                        const std::string &remote_agent,
@@ -220,21 +1134,113 @@ nixl_status_t nixlAgent::createXferReq(const nixl_xfer_dlist_t &local_descs,
                                        const nixl_xfer_op_t &operation,
                                        nixlXferReqH* &req_handle,
                                        const nixlBackendH* backend) const {
-    nixl_status_t ret;
+    nixl_status_t ret = createXferReqT(local_descs, remote_descs, remote_agent,
+                                       notif_msg, operation, req_handle, backend);
+
+    // No backend has both sides, but each side has one, so try through the
+    // staging buffers. Other failures keep their own error.
+    if (((ret == NIXL_ERR_NOT_FOUND) || (ret == NIXL_ERR_BACKEND)) &&
+        (backend == nullptr) &&
+        data->coveredApart(local_descs, remote_descs, remote_agent)) {
+        nixl_status_t staged_ret = data->createStaged(local_descs, remote_descs,
+                                                      remote_agent, notif_msg,
+                                                      operation, nullptr, nullptr,
+                                                      req_handle);
+        // Without staging buffers the direct error is more telling
+        if (staged_ret != NIXL_ERR_NOT_FOUND)
+            ret = staged_ret;
+    }
+    return ret;
+}
+
+nixl_status_t nixlAgent::createXferChain(const nixl_xfer_dlist_t &local_descs,
+                                         const nixl_xfer_dlist_t &remote_descs,
+                                         const std::string &remote_agent,
+                                         const std::string &notif_msg,
+                                         const nixl_xfer_op_t &operation,
+                                         nixlXferReqH* &req_handle,
+                                         const nixlBackendH* local_backend,
+                                         const nixlBackendH* remote_backend) const {
     req_handle = nullptr;
 
-    // Check the correspondence between descriptor lists
-    if (local_descs.descCount() != remote_descs.descCount())
-        return NIXL_ERR_INVALID_PARAM;
-    for (int i=0; i<local_descs.descCount(); ++i)
-        if (local_descs[i].len != remote_descs[i].len)
-            return NIXL_ERR_INVALID_PARAM;
+    nixl_status_t ret = checkXferArgs(local_descs, remote_descs, notif_msg,
+                                      operation);
+    if (ret != NIXL_SUCCESS)
+        return ret;
 
-    if ((notif_msg.size()==0) &&
-        ((operation==NIXL_WR_NOTIF) || (operation==NIXL_RD_NOTIF)))
-        return NIXL_ERR_INVALID_PARAM;
+    return data->createStaged(local_descs, remote_descs, remote_agent,
+                              notif_msg, operation, local_backend,
+                              remote_backend, req_handle);
+}
+
+nixl_status_t nixlAgent::createXferReq(const nixl_strided_dlist_t &local_descs,
+                                       const nixl_strided_dlist_t &remote_descs,
+                                       const std::string &remote_agent,
+                                       const std::string &notif_msg,
+                                       const nixl_xfer_op_t &operation,
+                                       nixlXferReqH* &req_handle,
+                                       const nixlBackendH* backend) const {
+    bool collapse = false;
+    int count = std::min(local_descs.descCount(), remote_descs.descCount());
+
+    // Before collapsing, which needs the extents to fit
+    nixl_status_t ret = checkXferArgs(local_descs, remote_descs, notif_msg,
+                                      operation);
+    if (ret != NIXL_SUCCESS) {
+        req_handle = nullptr;
+        return ret;
+    }
+
+    // Elements back to back on both sides can go as a single descriptor
+    for (int i=0; (i<count) && (!collapse); ++i) {
+        const nixlStridedDesc &l_desc = local_descs.descAt(i);
+        const nixlStridedDesc &r_desc = remote_descs.descAt(i);
+        collapse = (l_desc.count>1) && l_desc.isContiguous() &&
+                   r_desc.isContiguous() && (l_desc.len == r_desc.len) &&
+                   (l_desc.count == r_desc.count);
+    }
+    if (!collapse)
+        return createXferReqT(local_descs, remote_descs, remote_agent,
+                              notif_msg, operation, req_handle, backend);
+
+    nixl_strided_dlist_t local_copy(local_descs), remote_copy(remote_descs);
+    for (int i=0; i<count; ++i) {
+        nixlStridedDesc &l_desc = local_copy.descAt(i);
+        nixlStridedDesc &r_desc = remote_copy.descAt(i);
+        if ((l_desc.count>1) && l_desc.isContiguous() && r_desc.isContiguous() &&
+            (l_desc.len == r_desc.len) && (l_desc.count == r_desc.count)) {
+            // Start addresses don't change, so sorted lists stay sorted
+            l_desc.len   *= l_desc.count;
+            r_desc.len   *= r_desc.count;
+            l_desc.stride = l_desc.len;
+            r_desc.stride = r_desc.len;
+            l_desc.count  = 1;
+            r_desc.count  = 1;
+        }
+    }
+    return createXferReqT(local_copy, remote_copy, remote_agent,
+                          notif_msg, operation, req_handle, backend);
+}
+
+template <class Q>
+nixl_status_t nixlAgent::createXferReqT(const Q &local_descs,
+                                        const Q &remote_descs,
+                                        const std::string &remote_agent,
+                                        const std::string &notif_msg,
+                                        const nixl_xfer_op_t &operation,
+                                        nixlXferReqH* &req_handle,
+                                        const nixlBackendH* backend) const {
+    nixl_status_t ret;
+    req_handle = nullptr;
+
+    ret = checkXferArgs(local_descs, remote_descs, notif_msg, operation);
+    if (ret!=NIXL_SUCCESS)
+        return ret;
 
-    if (data->remoteSections.count(remote_agent)==0)
+    // No lock for remote info, the snapshot stays valid while it's held
+    remote_state_ptr_t state = data->getRemote();
+    auto s_itr = state->sections.find(remote_agent);
+    if (s_itr == state->sections.end())
         return NIXL_ERR_NOT_FOUND;
 
     // TODO: when central KV is supported, add a call to fetchRemoteMD
@@ -245,18 +1251,24 @@ nixl_status_t nixlAgent::createXferReq(const nixl_xfer_dlist_t &local_descs,
     handle->initiatorDescs = new nixl_meta_dlist_t (
                                      local_descs.getType(),
                                      local_descs.isUnifiedAddr(),
-                                     local_descs.isSorted());
+                                     respSorted(local_descs));
 
     if (backend==nullptr) {
+        static const backend_set_t no_backends;
+        auto b_itr = state->backends.find(remote_agent);
+        nixlSharedGuard guard(data->localLock);
         handle->engine = data->memorySection.findQuery(local_descs,
                               remote_descs.getType(),
-                              data->remoteBackends[remote_agent],
+                              (b_itr == state->backends.end()) ?
+                                  no_backends : b_itr->second,
                               *handle->initiatorDescs);
         if (handle->engine==nullptr) {
             delete handle;
             return NIXL_ERR_NOT_FOUND;
         }
+        handle->failover = true;
     } else {
+        nixlSharedGuard guard(data->localLock);
         ret = data->memorySection.populate(local_descs,
                                            backend->getType(),
                                            *handle->initiatorDescs);
@@ -275,10 +1287,11 @@ nixl_status_t nixlAgent::createXferReq(const nixl_xfer_dlist_t &local_descs,
     handle->targetDescs = new nixl_meta_dlist_t (
                                   remote_descs.getType(),
                                   remote_descs.isUnifiedAddr(),
-                                  remote_descs.isSorted());
+                                  respSorted(remote_descs));
 
     // Based on the decided local backend, we check the remote counterpart
-    ret = data->remoteSections[remote_agent]->populate(remote_descs,
+    handle->remoteSection = s_itr->second;
+    ret = handle->remoteSection->populate(remote_descs,
                handle->engine->getType(), *handle->targetDescs);
     if (ret!=NIXL_SUCCESS) {
         delete handle;
@@ -296,59 +1309,129 @@ nixl_status_t nixlAgent::createXferReq(const nixl_xfer_dlist_t &local_descs,
 }
 
 void nixlAgent::invalidateXferReq(nixlXferReqH *req) {
+    if (req->staged != nullptr) {
+        // Out of the progress thread's reach before it's freed
+        data->untrackStaged(req->staged);
+        data->releaseStaged(req->staged);
+    }
+    data->clearDeadline(req);
+    if (req->context != nullptr) {
+        req->context->release(req);
+        return;
+    }
     //destructor will call release to abort transfer if necessary
     delete req;
 }
 
-nixl_status_t nixlAgent::postXferReq(nixlXferReqH *req) {
-    nixl_status_t ret;
-
-    if (req==nullptr)
+nixl_status_t nixlAgent::setXferSignal(nixlXferReqH *req,
+                                       const nixlBasicDesc &remote_counter) const {
+    if ((req == nullptr) || req->remoteAgent.empty() ||
+        (remote_counter.len != sizeof(uint64_t)) ||
+        (remote_counter.addr % sizeof(uint64_t) != 0))
         return NIXL_ERR_INVALID_PARAM;
 
-    // We can't repost while a request is in progress
+    if (req->staged != nullptr)
+        return NIXL_ERR_NOT_ALLOWED;
+
+    if (!req->engine->supportsSignal())
+        return NIXL_ERR_BACKEND;
+
+    // Same as repost, a running request can't be changed
     if (req->status == NIXL_IN_PROG) {
         req->status = req->engine->checkXfer(req->backendHandle);
-        if (req->status == NIXL_IN_PROG) {
-            delete req;
+        if (req->status == NIXL_IN_PROG)
             return NIXL_ERR_REPOST_ACTIVE;
-        }
     }
 
+    remote_state_ptr_t state = data->getRemote();
+    auto s_itr = state->sections.find(req->remoteAgent);
+    if (s_itr == state->sections.end())
+        return NIXL_ERR_NOT_FOUND;
+
+    nixl_xfer_dlist_t counter(DRAM_SEG, true, true);
+    counter.addDesc(remote_counter);
+
+    nixl_meta_dlist_t* resp = new nixl_meta_dlist_t(DRAM_SEG, true, true);
+    nixl_status_t ret = s_itr->second->populate(counter, req->engine->getType(),
+                                                *resp);
+    if (ret != NIXL_SUCCESS) {
+        delete resp;
+        return ret;
+    }
+
+    delete req->signalDescs;
+    req->signalDescs   = resp;
+    req->signalSection = s_itr->second;
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t nixlAgent::postXferReq(nixlXferReqH *req,
+                                     const uint64_t timeout_us) {
+    if (req==nullptr)
+        return NIXL_ERR_INVALID_PARAM;
+
     // // The remote was invalidated
     // if (data->remoteBackends.count(req->remoteAgent)==0)
     //     delete req;
     //     return NIXL_ERR_BAD;
     // }
 
-    // If status is not NIXL_IN_PROG we can repost,
-    ret = (req->engine->postXfer (*req->initiatorDescs,
-                                   *req->targetDescs,
-                                   req->backendOp,
-                                   req->remoteAgent,
-                                   req->notifMsg,
-                                   req->backendHandle));
-    req->status = ret;
-    return ret;
+    if (req->staged == nullptr)
+        return data->submitXfer(req, timeout_us);
+
+    nixlStagedXfer* st = req->staged;
+    std::lock_guard<std::mutex> guard(st->lock);
+
+    // Same as for other requests, a running one keeps running
+    if (st->status == NIXL_IN_PROG) {
+        st->status = data->progressStaged(st);
+        if (st->status == NIXL_IN_PROG)
+            return NIXL_ERR_REPOST_ACTIVE;
+    }
+
+    data->stopStaged(st);
+    st->deadline = timeout_us ? nixlTime::getUs() + timeout_us : 0;
+    st->status = data->progressStaged(st);
+    if (st->status == NIXL_IN_PROG)
+        data->trackStaged(st);
+    return st->status;
 }
 
 nixl_status_t nixlAgent::getXferStatus (nixlXferReqH *req) {
-    // // The remote was invalidated
-    // if (data->remoteBackends.count(req->remoteAgent)==0)
-    //     delete req;
-    //     return NIXL_ERR_BAD;
-    // }
+    if (req->staged == nullptr)
+        return data->xferStatus(req);
+
+    nixlStagedXfer* st = req->staged;
+    std::lock_guard<std::mutex> guard(st->lock);
+    if (st->status == NIXL_IN_PROG)
+        st->status = data->progressStaged(st);
+    return st->status;
+}
 
-    // If the status is done, no need to recheck.
-    if (req->status != NIXL_SUCCESS)
-        req->status = req->engine->checkXfer(req->backendHandle);
+nixl_status_t nixlAgent::cancelXferReq (nixlXferReqH *req) {
+    if (req==nullptr)
+        return NIXL_ERR_INVALID_PARAM;
 
-    return req->status;
+    if (req->staged != nullptr) {
+        std::lock_guard<std::mutex> guard(req->staged->lock);
+        if (req->staged->status == NIXL_IN_PROG) {
+            data->stopStaged(req->staged);
+            req->staged->status = NIXL_ERR_NOT_POSTED;
+        }
+    } else if (req->status == NIXL_IN_PROG) {
+        data->stopXfer(req);
+        req->status = NIXL_ERR_NOT_POSTED;
+    }
+    return NIXL_SUCCESS;
 }
 
 
 nixlBackendH* nixlAgent::getXferBackend(const nixlXferReqH* req) const {
-    return data->backendHandles[req->engine->getType()];
+    if (req->staged != nullptr)
+        return nullptr;
+
+    nixlSharedGuard guard(data->localLock);
+    return data->backendHandles.at(req->engine->getType());
 }
 
 nixl_status_t nixlAgent::prepXferSide (const nixl_xfer_dlist_t &descs,
@@ -360,9 +1443,14 @@ nixl_status_t nixlAgent::prepXferSide (const nixl_xfer_dlist_t &descs,
     if (backend==nullptr)
         return NIXL_ERR_NOT_FOUND;
 
-    if (remote_agent.size()!=0)
-        if (data->remoteSections.count(remote_agent)==0)
+    remote_section_ptr_t section;
+    if (remote_agent.size()!=0) {
+        remote_state_ptr_t state = data->getRemote();
+        auto s_itr = state->sections.find(remote_agent);
+        if (s_itr == state->sections.end())
             return NIXL_ERR_NOT_FOUND;
+        section = s_itr->second;
+    }
 
     // TODO: when central KV is supported, add a call to fetchRemoteMD
     // TODO [Perf]: Avoid heap allocation on the datapath, maybe use a mem pool
@@ -379,13 +1467,14 @@ nixl_status_t nixlAgent::prepXferSide (const nixl_xfer_dlist_t &descs,
     if (remote_agent.size()==0) { // Local descriptor list
         handle->isLocal = true;
         handle->remoteAgent = "";
+        nixlSharedGuard guard(data->localLock);
         ret = data->memorySection.populate(
                    descs, backend->getType(), *handle->descs);
     } else {
         handle->isLocal = false;
         handle->remoteAgent = remote_agent;
-        ret = data->remoteSections[remote_agent]->populate(
-                   descs, backend->getType(), *handle->descs);
+        handle->remoteSection = section;
+        ret = section->populate(descs, backend->getType(), *handle->descs);
     }
 
     if (ret<0) {
@@ -393,6 +1482,17 @@ nixl_status_t nixlAgent::prepXferSide (const nixl_xfer_dlist_t &descs,
         return ret;
     }
 
+    // If all descriptors have the same length, as in paged buffers, index
+    // based requests from this side and a matching one skip length checks
+    handle->uniformLen = 0;
+    if (!handle->descs->isEmpty()) {
+        const nixlMetaDesc* side_descs = handle->descs->data();
+        size_t len = side_descs[0].len;
+        int i, count = handle->descs->descCount();
+        for (i=1; (i<count) && (side_descs[i].len==len); ++i);
+        if (i==count)
+            handle->uniformLen = len;
+    }
 
     side_handle = handle;
 
@@ -406,8 +1506,37 @@ nixl_status_t nixlAgent::makeXferReq (const nixlXferSideH* local_side,
                                       const std::string &notif_msg,
                                       const nixl_xfer_op_t &operation,
                                       nixlXferReqH* &req_handle) const {
-    req_handle     = nullptr;
-    int desc_count = (int) local_indices.size();
+    req_handle = nullptr;
+
+    if (local_indices.size() != remote_indices.size())
+        return NIXL_ERR_INVALID_PARAM;
+
+    return makeXferReq(local_side, local_indices.data(),
+                       remote_side, remote_indices.data(),
+                       (int) local_indices.size(),
+                       notif_msg, operation, req_handle);
+}
+
+// Makes d_list an empty unsorted list like side, reusing its storage
+static inline void resetSideList(nixl_meta_dlist_t* &d_list,
+                                 const nixl_meta_dlist_t &side) {
+    if ((d_list != nullptr) && (!d_list->isSorted()) &&
+        (d_list->getType() == side.getType()) &&
+        (d_list->isUnifiedAddr() == side.isUnifiedAddr()))
+        return;
+
+    delete d_list;
+    d_list = new nixl_meta_dlist_t(side.getType(), side.isUnifiedAddr(), false);
+}
+
+nixl_status_t nixlAgent::makeXferReq (const nixlXferSideH* local_side,
+                                      const int* local_indices,
+                                      const nixlXferSideH* remote_side,
+                                      const int* remote_indices,
+                                      const int &desc_count,
+                                      const std::string &notif_msg,
+                                      const nixl_xfer_op_t &operation,
+                                      nixlXferReqH* &req_handle) const {
 
     if ((!local_side->isLocal) || (remote_side->isLocal))
         return NIXL_ERR_INVALID_PARAM;
@@ -416,20 +1545,34 @@ nixl_status_t nixlAgent::makeXferReq (const nixlXferSideH* local_side,
         (local_side->engine != remote_side->engine))
         return NIXL_ERR_INVALID_PARAM;
 
-    if ((desc_count==0) || (remote_indices.size()==0) ||
-        (desc_count != (int) remote_indices.size()))
+    if (desc_count<=0)
         return NIXL_ERR_INVALID_PARAM;
 
-    for (int i=0; i<desc_count; ++i) {
-        if ((local_indices[i] >= local_side->descs->descCount())
-               || (local_indices[i]<0))
-            return NIXL_ERR_INVALID_PARAM;
-        if ((remote_indices[i] >= remote_side->descs->descCount())
-               || (remote_indices[i]<0))
-            return NIXL_ERR_INVALID_PARAM;
-        if ((*local_side->descs )[local_indices [i]].len !=
-            (*remote_side->descs)[remote_indices[i]].len)
-            return NIXL_ERR_INVALID_PARAM;
+    if ((req_handle != nullptr) && (req_handle->context != nullptr))
+        return NIXL_ERR_INVALID_PARAM;
+
+    const nixlMetaDesc* local_descs  = local_side->descs->data();
+    const nixlMetaDesc* remote_descs = remote_side->descs->data();
+    int local_count  = local_side->descs->descCount();
+    int remote_count = remote_side->descs->descCount();
+
+    // Indices are validated once here, so the loops below use unchecked
+    // access. Lengths are known to match if both sides have one length.
+    if ((local_side->uniformLen != 0) &&
+        (local_side->uniformLen == remote_side->uniformLen)) {
+        for (int i=0; i<desc_count; ++i)
+            if (((unsigned) local_indices[i] >= (unsigned) local_count) ||
+                ((unsigned) remote_indices[i] >= (unsigned) remote_count))
+                return NIXL_ERR_INVALID_PARAM;
+    } else {
+        for (int i=0; i<desc_count; ++i) {
+            if (((unsigned) local_indices[i] >= (unsigned) local_count) ||
+                ((unsigned) remote_indices[i] >= (unsigned) remote_count))
+                return NIXL_ERR_INVALID_PARAM;
+            if (local_descs[local_indices[i]].len !=
+                remote_descs[remote_indices[i]].len)
+                return NIXL_ERR_INVALID_PARAM;
+        }
     }
 
     if ((notif_msg.size()==0) &&
@@ -446,60 +1589,67 @@ nixl_status_t nixlAgent::makeXferReq (const nixlXferSideH* local_side,
     //     return NIXL_ERR_BAD;
     // }
 
-    // Populate has been already done, no benefit in having sorted descriptors
-    // which will be overwritten by [] assignment operator.
-    nixlXferReqH *handle = new nixlXferReqH;
-    handle->initiatorDescs = new nixl_meta_dlist_t (
-                                     local_side->descs->getType(),
-                                     local_side->descs->isUnifiedAddr(),
-                                     false, desc_count);
+    nixlXferReqH *handle = req_handle;
+    if (handle == nullptr) {
+        handle = new nixlXferReqH;
+    } else {
+        // Same as repost, a running request can't be changed
+        if (handle->status == NIXL_IN_PROG) {
+            handle->status = handle->engine->checkXfer(handle->backendHandle);
+            if (handle->status == NIXL_IN_PROG)
+                return NIXL_ERR_REPOST_ACTIVE;
+        }
+        data->stopXfer(handle);
+        // The signal was for the previous use, maybe with another remote
+        delete handle->signalDescs;
+        handle->signalDescs = nullptr;
+        handle->signalSection.reset();
+    }
 
-    handle->targetDescs = new nixl_meta_dlist_t (
-                                  remote_side->descs->getType(),
-                                  remote_side->descs->isUnifiedAddr(),
-                                  false, desc_count);
-
-    int i = 0, j = 0; //final list size
-    while(i<(desc_count)) {
-        nixlMetaDesc local_desc1 = (*local_side->descs)[local_indices[i]];
-        nixlMetaDesc remote_desc1 = (*remote_side->descs)[remote_indices[i]];
-
-        if(i != (desc_count-1) ) {
-            nixlMetaDesc local_desc2 = (*local_side->descs)[local_indices[i+1]];
-            nixlMetaDesc remote_desc2 = (*remote_side->descs)[remote_indices[i+1]];
-
-          while(((local_desc1.addr + local_desc1.len) == local_desc2.addr)
-             && ((remote_desc1.addr + remote_desc1.len) == remote_desc2.addr)
-             && (local_desc1.metadataP == local_desc2.metadataP)
-             && (remote_desc1.metadataP == remote_desc2.metadataP)
-             && (local_desc1.devId == local_desc2.devId)
-             && (remote_desc1.devId == remote_desc2.devId))
-            {
-                local_desc1.len += local_desc2.len;
-                remote_desc1.len += remote_desc2.len;
+    // Populate has been already done, no benefit in having sorted descriptors
+    resetSideList(handle->initiatorDescs, *local_side->descs);
+    resetSideList(handle->targetDescs, *remote_side->descs);
+    handle->initiatorDescs->resize(desc_count);
+    handle->targetDescs->resize(desc_count);
 
-                i++;
-                if(i == (desc_count-1)) break;
+    nixlMetaDesc* local_out  = &handle->initiatorDescs->descAt(0);
+    nixlMetaDesc* remote_out = &handle->targetDescs->descAt(0);
+    int j = -1; //final list size - 1
 
-                local_desc2 = (*local_side->descs)[local_indices[i+1]];
-                remote_desc2 = (*remote_side->descs)[remote_indices[i+1]];
-            }
+    // Descriptors back to back in memory on both sides are merged into the
+    // last output ones, which are updated in place
+    for (int i=0; i<desc_count; ++i) {
+        const nixlMetaDesc &local_desc  = local_descs[local_indices[i]];
+        const nixlMetaDesc &remote_desc = remote_descs[remote_indices[i]];
+
+        if ((j >= 0)
+            && ((local_out[j].addr + local_out[j].len) == local_desc.addr)
+            && ((remote_out[j].addr + remote_out[j].len) == remote_desc.addr)
+            && (local_out[j].metadataP == local_desc.metadataP)
+            && (remote_out[j].metadataP == remote_desc.metadataP)
+            && (local_out[j].devId == local_desc.devId)
+            && (remote_out[j].devId == remote_desc.devId)) {
+            local_out[j].len  += local_desc.len;
+            remote_out[j].len += remote_desc.len;
+        } else {
+            // Lists are unsorted and j<=i, so unchecked access is safe
+            ++j;
+            local_out[j]  = local_desc;
+            remote_out[j] = remote_desc;
         }
-
-        (*handle->initiatorDescs)[j] = local_desc1;
-        (*handle->targetDescs)[j] = remote_desc1;
-        j++;
-        i++;
     }
 
-    handle->initiatorDescs->resize(j);
-    handle->targetDescs->resize(j);
+    handle->initiatorDescs->resize(j+1);
+    handle->targetDescs->resize(j+1);
 
     // To be added to logging
-    //std::cout << "reqH descList size down to " << j << "\n";
+    //std::cout << "reqH descList size down to " << j+1 << "\n";
 
-    handle->engine      = local_side->engine;
-    handle->remoteAgent = remote_side->remoteAgent;
+    handle->engine        = local_side->engine;
+    handle->remoteAgent   = remote_side->remoteAgent;
+    // Avoids the reference count update if reused for the same remote side
+    if (handle->remoteSection != remote_side->remoteSection)
+        handle->remoteSection = remote_side->remoteSection;
     handle->notifMsg    = notif_msg;
     handle->backendOp   = operation;
     handle->status      = NIXL_ERR_NOT_POSTED;
@@ -518,11 +1668,16 @@ nixl_status_t nixlAgent::genNotif(const std::string &remote_agent,
     if (backend!=nullptr)
         return backend->engine->genNotif(remote_agent, msg);
 
+    remote_state_ptr_t state = data->getRemote();
+    auto b_itr = state->backends.find(remote_agent);
+    if (b_itr == state->backends.end())
+        return NIXL_ERR_NOT_FOUND;
+
     // TODO: add logic to choose between backends if multiple support it
+    nixlSharedGuard guard(data->localLock);
     for (auto & eng: data->backendEngines) {
         if (eng.second->supportsNotif()) {
-            if (data->remoteBackends[remote_agent].count(
-                                    eng.second->getType()) != 0)
+            if (b_itr->second.count(eng.second->getType()) != 0)
                 return eng.second->genNotif(remote_agent, msg);
         }
     }
@@ -537,6 +1692,7 @@ int nixlAgent::getNotifs(nixl_notifs_t &notif_map) {
     // Doing best effort, if any backend errors out we return
     // error but proceed with the rest. We can add metadata about
     // the backend to the msg, but user could put it themselves.
+    nixlSharedGuard guard(data->localLock);
     for (auto & eng: data->backendEngines) {
         if (eng.second->supportsNotif()) {
             any_backend = true;
@@ -566,7 +1722,66 @@ int nixlAgent::getNotifs(nixl_notifs_t &notif_map) {
         return tot;
 }
 
+int nixlAgent::getNotifs(nixlNotifArena &arena) {
+    int ret, bad_ret=0, tot=0;
+    bool any_backend = false;
+
+    // Same best effort as above
+    nixlSharedGuard guard(data->localLock);
+    for (auto & eng: data->backendEngines) {
+        if (eng.second->supportsNotif()) {
+            any_backend = true;
+            ret = eng.second->drainNotifs(arena);
+            if (ret<0)
+                bad_ret=ret;
+            else
+                tot += ret;
+        }
+    }
+
+    if (bad_ret)
+        return bad_ret;
+    else if (!any_backend)
+        return -1;
+    else
+        return tot;
+}
+
+nixl_status_t nixlAgent::setNotifCallback(nixl_notif_cb_t cb, void* arg) {
+    nixl_status_t ret;
+    bool any_backend = false;
+
+    std::lock_guard<std::mutex> ctrl_guard(data->ctrlLock);
+    nixlSharedGuard guard(data->localLock);
+
+    for (auto & eng: data->backendEngines) {
+        if (eng.second->supportsNotif()) {
+            any_backend = true;
+            ret = eng.second->setNotifCallback(cb, arg);
+            if (ret != NIXL_SUCCESS) {
+                // Put back the previous one on the backends already changed
+                for (auto & prev: data->backendEngines) {
+                    if (prev.second == eng.second)
+                        break;
+                    if (prev.second->supportsNotif())
+                        prev.second->setNotifCallback(data->notifCb,
+                                                      data->notifCbArg);
+                }
+                return ret;
+            }
+        }
+    }
+
+    if (!any_backend)
+        return NIXL_ERR_NOT_FOUND;
+
+    data->notifCb    = cb;
+    data->notifCbArg = arg;
+    return NIXL_SUCCESS;
+}
+
 std::string nixlAgent::getLocalMD () const {
+    nixlSharedGuard guard(data->localLock);
     // data->connMD was populated when the backend was created
     size_t conn_cnt = data->connMD.size();
     nixl_backend_t nixl_backend;
@@ -574,7 +1789,7 @@ std::string nixlAgent::getLocalMD () const {
     if (conn_cnt == 0) // Error, no backend supports remote
         return "";
 
-    nixlSerDes sd;
+    nixlSerDes sd(data->config.compressMD);
     if (sd.addStr("Agent", data->name)<0)
         return "";
 
@@ -599,6 +1814,38 @@ std::string nixlAgent::getLocalMD () const {
 }
 
 std::string nixlAgent::loadRemoteMD (const std::string &remote_metadata) {
+    return loadRemoteMD(remote_metadata.data(), remote_metadata.size());
+}
+
+std::string nixlAgent::loadRemoteMDFile (const std::string &file_path) {
+    struct stat st;
+    void* buf;
+    std::string ret;
+
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return "";
+
+    if ((fstat(fd, &st) < 0) || (st.st_size == 0)) {
+        close(fd);
+        return "";
+    }
+
+    // Pages are brought in as they are deserialized, and can be dropped
+    // by the kernel afterwards, so no full copy of the blob is kept.
+    buf = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (buf == MAP_FAILED)
+        return "";
+
+    madvise(buf, st.st_size, MADV_SEQUENTIAL);
+    ret = loadRemoteMD(buf, st.st_size);
+    munmap(buf, st.st_size);
+    return ret;
+}
+
+std::string nixlAgent::loadRemoteMD (const void* remote_metadata,
+                                     const size_t &len) {
     int count = 0;
     nixlSerDes sd;
     size_t conn_cnt;
@@ -606,7 +1853,7 @@ std::string nixlAgent::loadRemoteMD (const std::string &remote_metadata) {
     nixl_backend_t nixl_backend;
     nixlBackendEngine* eng;
 
-    if (sd.importStr(remote_metadata)<0)
+    if (sd.importView(remote_metadata, len)<0)
         return "";
 
     std::string remote_agent = sd.getStr("Agent");
@@ -622,60 +1869,66 @@ std::string nixlAgent::loadRemoteMD (const std::string &remote_metadata) {
     if (conn_cnt<1)
         return "";
 
+    // Readers keep using the published state while the new one is prepared
+    std::lock_guard<std::mutex> guard(data->ctrlLock);
+    std::shared_ptr<nixlRemoteState> state =
+                        std::make_shared<nixlRemoteState>(*data->getRemote());
+    bool load_err = false;
+
     for (size_t i=0; i<conn_cnt; ++i) {
         nixl_backend = sd.getStr("t");
-        if (nixl_backend.size()==0)
-            return "";
         conn_info = sd.getStr("c");
-        if (conn_info.size()==0) // Fine if doing marginal updates
-            return "";
+        // Empty conn_info is fine if doing marginal updates, but not supported
+        if ((nixl_backend.size()==0) || (conn_info.size()==0)) {
+            load_err = true;
+            break;
+        }
 
         // Current agent might not support a remote backend
         if (data->backendEngines.count(nixl_backend)!=0) {
 
             // No need to reload same conn info, (TODO to cache the old val?)
-            if (data->remoteBackends.count(remote_agent)!=0)
-                if (data->remoteBackends[remote_agent].count(nixl_backend)!=0) {
+            if (state->backends.count(remote_agent)!=0)
+                if (state->backends[remote_agent].count(nixl_backend)!=0) {
                     count++;
                     continue;
                 }
 
             eng = data->backendEngines[nixl_backend];
-            if (eng->supportsRemote()) {
-                if (eng->loadRemoteConnInfo(remote_agent, conn_info)
-                                            != NIXL_SUCCESS)
-                    return ""; // Error in load
-                count++;
-                data->remoteBackends[remote_agent].insert(nixl_backend);
-            } else {
-                return ""; // This is an erroneous case
+            // Not supporting remote is an erroneous case
+            if ((!eng->supportsRemote()) ||
+                (eng->loadRemoteConnInfo(remote_agent, conn_info)
+                                         != NIXL_SUCCESS)) {
+                load_err = true;
+                break;
             }
+            count++;
+            state->backends[remote_agent].insert(nixl_backend);
         }
     }
 
-    // No common backend, no point in loading the rest, unexpected
-    if (count == 0)
-        return "";
-
     // If there was an issue and we return -1 while some connections
-    // are loaded, they will be deleted in backend destructor.
-    // the backend connection list for this agent will be empty.
+    // are loaded, they will be deleted in backend destructor. They are
+    // published anyway, as the backends don't accept reloading them.
 
+    // No common backend, no point in loading the rest, unexpected
     // It's just a check, not introducing section_info
-    conn_info = sd.getStr("");
-    if (conn_info != "MemSection")
+    if (load_err || (count == 0) || (sd.getStr("") != "MemSection")) {
+        data->setRemote(state);
         return "";
+    }
 
-    if (data->remoteSections.count(remote_agent) == 0)
-        data->remoteSections[remote_agent] = new nixlRemoteSection(
-                            remote_agent, data->backendEngines);
-
-    if (data->remoteSections[remote_agent]->loadRemoteData(&sd)<0) {
-        delete data->remoteSections[remote_agent];
-        data->remoteSections.erase(remote_agent);
+    // An update replaces the section, the old one is freed after its
+    // current users are done. On error the old one is kept.
+    remote_section_ptr_t section = std::make_shared<nixlRemoteSection>(
+                                       remote_agent, data->backendEngines);
+    if (section->loadRemoteData(&sd)<0) {
+        data->setRemote(state);
         return "";
     }
 
+    state->sections[remote_agent] = section;
+    data->setRemote(state);
     return remote_agent;
 }
 
@@ -683,19 +1936,183 @@ nixl_status_t nixlAgent::invalidateRemoteMD(const std::string &remote_agent) {
     if (remote_agent == data->name)
         return NIXL_ERR_INVALID_PARAM;
 
-    nixl_status_t ret = NIXL_ERR_NOT_FOUND;
-    if (data->remoteSections.count(remote_agent)!=0) {
-        delete data->remoteSections[remote_agent];
-        data->remoteSections.erase(remote_agent);
-        ret = NIXL_SUCCESS;
+    std::lock_guard<std::mutex> guard(data->ctrlLock);
+    return data->invalidateRemote(remote_agent);
+}
+
+/*** Class nixlXferContext implementation ***/
+
+nixlXferContextData::nixlXferContextData(nixlAgentData* agent_data) {
+    agentData    = agent_data;
+    remoteRefs   = 0;
+    lastSection  = nullptr;
+    lastBackends = nullptr;
+    refreshLocal();
+    refreshRemote();
+}
+
+nixlXferContextData::~nixlXferContextData() {
+    for (auto & req : freeReqs)
+        delete req;
+}
+
+void nixlXferContextData::refreshLocal() {
+    nixlSharedGuard guard(agentData->localLock);
+    localGen = agentData->localGen.load(std::memory_order_relaxed);
+    localView.copyFrom(agentData->memorySection);
+}
+
+void nixlXferContextData::refreshRemote() {
+    // Generation first, a newer snapshot than it only causes another refresh
+    remoteGen = agentData->remoteGen.load(std::memory_order_acquire);
+    if (remoteRefs > 0)
+        retired[remote.get()] = std::make_pair(remote, remoteRefs);
+    remote       = agentData->getRemote();
+    remoteRefs   = 0;
+    lastAgent.clear();
+    lastSection  = nullptr;
+    lastBackends = nullptr;
+}
+
+void nixlXferContextData::release(nixlXferReqH* req) {
+    agentData->stopXfer(req);
+
+    if (req->pinnedState == remote.get()) {
+        remoteRefs--;
+    } else if (req->pinnedState != nullptr) {
+        auto it = retired.find(req->pinnedState);
+        if (--it->second.second == 0)
+            retired.erase(it);
+    }
+    req->pinnedState = nullptr;
+    // Set if it failed over to another backend
+    req->remoteSection.reset();
+    // The next user of the request sets its own signal
+    delete req->signalDescs;
+    req->signalDescs = nullptr;
+    req->signalSection.reset();
+
+    freeReqs.push_back(req);
+}
+
+nixlXferContext::nixlXferContext(const nixlAgent &agent) {
+    data = new nixlXferContextData(agent.data);
+}
+
+nixlXferContext::~nixlXferContext() {
+    delete data;
+}
+
+// Makes sure d_list can be the populate output for query, reusing its storage
+static inline void resetDescList(nixl_meta_dlist_t* &d_list,
+                                 const nixl_xfer_dlist_t &query) {
+    if ((d_list != nullptr) &&
+        (d_list->getType() == query.getType()) &&
+        (d_list->isUnifiedAddr() == query.isUnifiedAddr()) &&
+        (d_list->isSorted() == query.isSorted()))
+        return;
+
+    delete d_list;
+    d_list = new nixl_meta_dlist_t(query.getType(), query.isUnifiedAddr(),
+                                   query.isSorted());
+}
+
+nixl_status_t nixlXferContext::createXferReq(const nixl_xfer_dlist_t &local_descs,
+                                             const nixl_xfer_dlist_t &remote_descs,
+                                             const std::string &remote_agent,
+                                             const std::string &notif_msg,
+                                             const nixl_xfer_op_t &operation,
+                                             nixlXferReqH* &req_handle,
+                                             const nixlBackendH* backend) {
+    nixlAgentData* agent_data = data->agentData;
+    nixl_status_t ret;
+    req_handle = nullptr;
+
+    ret = checkXferArgs(local_descs, remote_descs, notif_msg, operation);
+    if (ret!=NIXL_SUCCESS)
+        return ret;
+
+    // Only reads of the generations are shared with other threads when
+    // nothing has changed, and these cache lines are rarely written
+    if (agent_data->localGen.load(std::memory_order_acquire) != data->localGen)
+        data->refreshLocal();
+    if (agent_data->remoteGen.load(std::memory_order_acquire) != data->remoteGen)
+        data->refreshRemote();
+
+    if ((data->lastSection == nullptr) || (data->lastAgent != remote_agent)) {
+        auto s_itr = data->remote->sections.find(remote_agent);
+        if (s_itr == data->remote->sections.end())
+            return NIXL_ERR_NOT_FOUND;
+        auto b_itr = data->remote->backends.find(remote_agent);
+        data->lastAgent    = remote_agent;
+        data->lastSection  = s_itr->second.get();
+        data->lastBackends = (b_itr == data->remote->backends.end()) ?
+                                 nullptr : &b_itr->second;
     }
 
-    if (data->remoteBackends.count(remote_agent)!=0) {
-        for (auto & elm: data->remoteBackends[remote_agent])
-            data->backendEngines[elm]->disconnect(remote_agent);
-        data->remoteBackends.erase(remote_agent);
-        ret = NIXL_SUCCESS;
+    nixlXferReqH *handle;
+    if (data->freeReqs.empty()) {
+        handle = new nixlXferReqH;
+        handle->context = data;
+    } else {
+        handle = data->freeReqs.back();
+        data->freeReqs.pop_back();
     }
+    resetDescList(handle->initiatorDescs, local_descs);
 
-    return ret;
+    if (backend==nullptr) {
+        static const backend_set_t no_backends;
+        handle->engine = data->localView.findQuery(local_descs,
+                              remote_descs.getType(),
+                              (data->lastBackends == nullptr) ?
+                                  no_backends : *data->lastBackends,
+                              *handle->initiatorDescs);
+        if (handle->engine==nullptr) {
+            data->freeReqs.push_back(handle);
+            return NIXL_ERR_NOT_FOUND;
+        }
+        handle->failover = true;
+    } else {
+        ret = data->localView.populate(local_descs,
+                                       backend->getType(),
+                                       *handle->initiatorDescs);
+        if (ret!=NIXL_SUCCESS) {
+            data->freeReqs.push_back(handle);
+            return NIXL_ERR_BACKEND;
+        }
+        handle->engine   = backend->engine;
+        handle->failover = false;
+    }
+
+    if ((notif_msg.size()!=0) && (!handle->engine->supportsNotif())) {
+        data->freeReqs.push_back(handle);
+        return NIXL_ERR_BACKEND;
+    }
+
+    resetDescList(handle->targetDescs, remote_descs);
+
+    // Based on the decided local backend, we check the remote counterpart
+    ret = data->lastSection->populate(remote_descs,
+               handle->engine->getType(), *handle->targetDescs);
+    if (ret!=NIXL_SUCCESS) {
+        data->freeReqs.push_back(handle);
+        return ret;
+    }
+
+    // The snapshot keeps the section alive for the request
+    handle->pinnedState = data->remote.get();
+    data->remoteRefs++;
+
+    handle->remoteAgent = remote_agent;
+    handle->notifMsg    = notif_msg;
+    handle->backendOp   = operation;
+    handle->status      = NIXL_ERR_NOT_POSTED;
+
+    req_handle = handle;
+
+    return NIXL_SUCCESS;
+}
+
+void nixlXferContext::releaseXferReq(nixlXferReqH* req) {
+    data->release(req);
 }
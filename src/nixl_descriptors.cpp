@@ -18,6 +18,8 @@
 #include <iostream>
 #include <functional>
 #include <stdexcept>
+#include <cstdint>
+#include <cstring>
 #include "nixl.h"
 #include "nixl_descriptors.h"
 #include "backend/backend_engine.h"
@@ -36,9 +38,12 @@ nixlBasicDesc::nixlBasicDesc(const uintptr_t &addr,
     this->devId = dev_id;
 }
 
-nixlBasicDesc::nixlBasicDesc(const std::string &str) {
-    if (str.size()==sizeof(nixlBasicDesc)) {
-        str.copy(reinterpret_cast<char*>(this), sizeof(nixlBasicDesc));
+nixlBasicDesc::nixlBasicDesc(const std::string &str) :
+                             nixlBasicDesc(str.data(), str.size()) {}
+
+nixlBasicDesc::nixlBasicDesc(const char* buf, const size_t &size) {
+    if (size==sizeof(nixlBasicDesc)) {
+        memcpy(reinterpret_cast<char*>(this), buf, sizeof(nixlBasicDesc));
     } else { // Error indicator, not possible by descList deserializer call
         addr  = 0;
         len   = 0;
@@ -100,13 +105,15 @@ nixlStringDesc::nixlStringDesc(const nixlBasicDesc &desc,
     this->metaInfo = meta_info;
 }
 
-nixlStringDesc::nixlStringDesc(const std::string &str) {
-    size_t meta_size = str.size() - sizeof(nixlBasicDesc);
-    if (meta_size>0) {
-        metaInfo.resize(meta_size);
-        str.copy(reinterpret_cast<char*>(this), sizeof(nixlBasicDesc));
-        str.copy(reinterpret_cast<char*>(&metaInfo[0]),
-                 meta_size, sizeof(nixlBasicDesc));
+nixlStringDesc::nixlStringDesc(const std::string &str) :
+                               nixlStringDesc(str.data(), str.size()) {}
+
+nixlStringDesc::nixlStringDesc(const char* buf, const size_t &size) {
+    if (size>sizeof(nixlBasicDesc)) {
+        memcpy(reinterpret_cast<char*>(static_cast<nixlBasicDesc*>(this)),
+               buf, sizeof(nixlBasicDesc));
+        metaInfo.assign(buf + sizeof(nixlBasicDesc),
+                        size - sizeof(nixlBasicDesc));
     } else { // Error indicator, not possible by descList deserializer call
         addr  = 0;
         len   = 0;
@@ -132,11 +139,177 @@ void nixlStringDesc::print(const std::string &suffix) const {
     nixlBasicDesc::print(", Metadata: " + metaInfo + suffix);
 }
 
+/*** Class nixlStridedDesc implementation ***/
+
+nixlStridedDesc::nixlStridedDesc(const uintptr_t &addr,
+                                 const size_t &elem_len,
+                                 const size_t &stride,
+                                 const size_t &count,
+                                 const uint32_t &dev_id) :
+                                 nixlBasicDesc(addr, elem_len, dev_id) {
+    this->stride = stride;
+    this->count  = count;
+}
+
+nixlStridedDesc::nixlStridedDesc(const nixlBasicDesc &desc) :
+                                 nixlBasicDesc(desc) {
+    stride = desc.len;
+    count  = 1;
+}
+
+nixlStridedDesc::nixlStridedDesc(const std::string &str) :
+                                 nixlStridedDesc(str.data(), str.size()) {}
+
+nixlStridedDesc::nixlStridedDesc(const char* buf, const size_t &size) {
+    if (size==sizeof(nixlStridedDesc)) {
+        memcpy(reinterpret_cast<char*>(this), buf, sizeof(nixlStridedDesc));
+    } else { // Error indicator
+        addr   = 0;
+        len    = 0;
+        devId  = 0;
+        stride = 0;
+        count  = 0;
+    }
+}
+
+bool operator==(const nixlStridedDesc &lhs, const nixlStridedDesc &rhs) {
+    return (((nixlBasicDesc)lhs == (nixlBasicDesc)rhs) &&
+            (lhs.stride == rhs.stride) && (lhs.count == rhs.count));
+}
+
+bool operator!=(const nixlStridedDesc &lhs, const nixlStridedDesc &rhs) {
+    return !(lhs==rhs);
+}
+
+bool nixlStridedDesc::validExtent() const {
+    if (count==0)
+        return false;
+    if ((count > 1) && (stride > (SIZE_MAX - len) / (count-1)))
+        return false;
+    return (stride * (count-1) + len <= UINTPTR_MAX - addr);
+}
+
+nixlBasicDesc nixlStridedDesc::extent() const {
+    if (count==0)
+        return nixlBasicDesc(addr, 0, devId);
+    return nixlBasicDesc(addr, stride * (count-1) + len, devId);
+}
+
+std::string nixlStridedDesc::serialize() const {
+    return std::string(reinterpret_cast<const char*>(this),
+                       sizeof(nixlStridedDesc));
+}
+
+void nixlStridedDesc::print(const std::string &suffix) const {
+    nixlBasicDesc::print(", stride " + std::to_string(stride) +
+                         ", count " + std::to_string(count) + suffix);
+}
+
 /*** Class nixlDescList implementation ***/
 
 // The template is used to select from nixlBasicDesc/nixlMetaDesc/nixlStringDesc
 // There are no virtual functions, so the object is all data, no pointers.
 
+// Compact encoding of the descriptors, used if serializer has compression.
+// Each field is a zigzag varint delta from the previous descriptor, with
+// addr relative to the end of previous one, so back to back blocks of the
+// same size take 3 bytes. metaInfo is stored as the length of the prefix
+// shared with previous metaInfo, and the remaining bytes.
+
+static inline uint64_t zigzag (const int64_t &val) {
+    return ((uint64_t) val << 1) ^ (uint64_t) (val >> 63);
+}
+
+static inline int64_t unzigzag (const uint64_t &val) {
+    return (int64_t) (val >> 1) ^ -((int64_t) (val & 1));
+}
+
+// Only nixlStringDesc has metaInfo to be encoded
+static inline const std::string* descMeta (const nixlBasicDesc &desc) {
+    return nullptr;
+}
+
+static inline const std::string* descMeta (const nixlStringDesc &desc) {
+    return &desc.metaInfo;
+}
+
+static inline std::string* descMeta (nixlBasicDesc &desc) {
+    return nullptr;
+}
+
+static inline std::string* descMeta (nixlStringDesc &desc) {
+    return &desc.metaInfo;
+}
+
+template <class T>
+static void encodeDescs (const std::vector<T> &descs, std::string &out) {
+    nixlBasicDesc prev(0, 0, 0);
+    const std::string empty;
+    const std::string *meta, *prev_meta = &empty;
+    size_t shared, max_shared;
+
+    for (auto & elm : descs) {
+        nixlSerDes::_appendVarint(out, zigzag(elm.addr - (prev.addr + prev.len)));
+        nixlSerDes::_appendVarint(out, zigzag(elm.len - prev.len));
+        nixlSerDes::_appendVarint(out, zigzag((int64_t) elm.devId - prev.devId));
+        prev = elm;
+
+        meta = descMeta(elm);
+        if (meta == nullptr)
+            continue;
+        shared = 0;
+        max_shared = std::min(meta->size(), prev_meta->size());
+        while ((shared < max_shared) && ((*meta)[shared] == (*prev_meta)[shared]))
+            shared++;
+        nixlSerDes::_appendVarint(out, shared);
+        nixlSerDes::_appendVarint(out, meta->size() - shared);
+        out.append(*meta, shared, std::string::npos);
+        prev_meta = meta;
+    }
+}
+
+template <class T>
+static bool decodeDescs (const char* ptr, const char* end,
+                         const size_t &n_desc, std::vector<T> &descs) {
+    nixlBasicDesc prev(0, 0, 0);
+    const std::string empty;
+    const std::string *prev_meta = &empty;
+    uint64_t addr, len, dev_id, shared, rest;
+    std::string *meta;
+
+    // Every field takes at least a byte, reject a count the buffer can't
+    // hold before allocating for it
+    size_t min_len = std::is_same<nixlStringDesc, T>::value ? 5 : 3;
+    if (n_desc > (size_t) (end - ptr) / min_len)
+        return false;
+
+    descs.resize(n_desc);
+    for (auto & elm : descs) {
+        if (!nixlSerDes::_readVarint(ptr, end, addr) ||
+            !nixlSerDes::_readVarint(ptr, end, len) ||
+            !nixlSerDes::_readVarint(ptr, end, dev_id))
+            return false;
+        elm.addr  = prev.addr + prev.len + unzigzag(addr);
+        elm.len   = prev.len + unzigzag(len);
+        elm.devId = prev.devId + unzigzag(dev_id);
+        prev = elm;
+
+        meta = descMeta(elm);
+        if (meta == nullptr)
+            continue;
+        if (!nixlSerDes::_readVarint(ptr, end, shared) ||
+            !nixlSerDes::_readVarint(ptr, end, rest) ||
+            (shared > prev_meta->size()) || (rest > (uint64_t) (end - ptr)))
+            return false;
+        meta->reserve(shared + rest);
+        meta->assign(*prev_meta, 0, shared);
+        meta->append(ptr, rest);
+        ptr += rest;
+        prev_meta = meta;
+    }
+    return (ptr == end);
+}
+
 template <class T>
 nixlDescList<T>::nixlDescList (const nixl_mem_t &type, const bool &unified_addr,
                                const bool &sorted, const int &init_size) {
@@ -171,30 +344,49 @@ nixlDescList<T>::nixlDescList(nixlSerDes* deserializer) {
     if (deserializer->getBuf("n", &n_desc, sizeof(n_desc)))
         return;
 
-    if (std::is_same<nixlBasicDesc, T>::value) {
+    // Read directly from the deserializer buffer, no intermediate strings
+    const char* buf;
+    ssize_t buf_len;
+
+    if (deserializer->descCompression()) {
+        if (!(((str=="nixlBDList") && std::is_same<nixlBasicDesc, T>::value) ||
+              ((str=="nixlSDList") && std::is_same<nixlStringDesc, T>::value)))
+            return;
+        if (n_desc==0)
+            return;
+        if ((deserializer->getStrView("", buf, buf_len)) ||
+            (!decodeDescs(buf, buf + buf_len, n_desc, descs)))
+            descs.clear();
+    } else if (std::is_same<nixlBasicDesc, T>::value) {
         // Contiguous in memory, so no need for per elm deserialization
         if (str!="nixlBDList")
             return;
-        str = deserializer->getStr("");
-        if (str.size()!= n_desc * sizeof(nixlBasicDesc))
+        if (deserializer->getStrView("", buf, buf_len))
+            return;
+        if ((size_t) buf_len != n_desc * sizeof(nixlBasicDesc))
             return;
         // If size is proper, deserializer cannot fail
         descs.resize(n_desc);
-        str.copy(reinterpret_cast<char*>(descs.data()), str.size());
+        memcpy(reinterpret_cast<char*>(descs.data()), buf, buf_len);
 
     } else if(std::is_same<nixlStringDesc, T>::value) {
         if (str!="nixlSDList")
             return;
+        // Each one takes its length, a nixlBasicDesc and the separator,
+        // so a count the buffer can't hold isn't reserved for
+        if (n_desc > deserializer->remainingLen() /
+                     (sizeof(ssize_t) + sizeof(nixlBasicDesc) + 1))
+            return;
+        descs.reserve(n_desc);
         for (size_t i=0; i<n_desc; ++i) {
-            str = deserializer->getStr("");
             // If size is proper, deserializer cannot fail
             // Allowing empty strings, might change later
-            if (str.size() < sizeof(nixlBasicDesc)) {
+            if ((deserializer->getStrView("", buf, buf_len)) ||
+                ((size_t) buf_len < sizeof(nixlBasicDesc))) {
                 descs.clear();
                 return;
             }
-            T elm(str);
-            descs.push_back(elm);
+            descs.emplace_back(buf, (size_t) buf_len);
         }
     } else {
         return; // Unknown type, error
@@ -248,6 +440,33 @@ void nixlDescList<T>::addDesc (const T &desc) {
     }
 }
 
+// Elements from old_size onward are newly appended, sort them and merge them
+// with the already sorted part: O(k log k + n) instead of k vector inserts.
+template <class T>
+void nixlDescList<T>::mergeAppended (const size_t &old_size) {
+    if (!sorted || (old_size == descs.size()))
+        return;
+
+    // stable versions to keep the same order for equal keys as addDesc
+    std::stable_sort(descs.begin() + old_size, descs.end(), desc_comparator_f);
+    std::inplace_merge(descs.begin(), descs.begin() + old_size,
+                       descs.end(), desc_comparator_f);
+}
+
+template <class T>
+void nixlDescList<T>::addDescs (const std::vector<T> &new_descs) {
+    size_t old_size = descs.size();
+    descs.insert(descs.end(), new_descs.begin(), new_descs.end());
+    mergeAppended(old_size);
+}
+
+template <class T>
+void nixlDescList<T>::addDescs (const nixlDescList<T> &d_list) {
+    size_t old_size = descs.size();
+    descs.insert(descs.end(), d_list.descs.begin(), d_list.descs.end());
+    mergeAppended(old_size);
+}
+
 template <class T>
 bool nixlDescList<T>::overlaps (const T &desc, int &index) const {
     if (!sorted) {
@@ -301,6 +520,31 @@ nixl_status_t nixlDescList<T>::remDesc (const int &index){
     return NIXL_SUCCESS;
 }
 
+// All indices are checked before any removal, so on error the list is intact.
+// Duplicate indices are allowed. Relative order of the rest is kept.
+template <class T>
+nixl_status_t nixlDescList<T>::remDescs (const std::vector<int> &indices) {
+    size_t size = descs.size();
+    std::vector<bool> remove(size, false);
+
+    for (auto & index : indices) {
+        if (((size_t) index >= size) || (index < 0))
+            return NIXL_ERR_INVALID_PARAM;
+        remove[index] = true;
+    }
+
+    size_t j = 0;
+    for (size_t i=0; i<size; ++i) {
+        if (remove[i])
+            continue;
+        if (i != j)
+            descs[j] = std::move(descs[i]);
+        j++;
+    }
+    descs.resize(j);
+    return NIXL_SUCCESS;
+}
+
 template <class T>
 void nixlDescList<T>::resize (const size_t &count) {
     if (count > descs.size())
@@ -358,8 +602,8 @@ nixl_status_t nixlDescList<T>::populate (const nixlDescList<nixlBasicDesc> &quer
     if (!sorted) {
         for (int i=0; i<query.descCount(); ++i)
             for (auto & elm : descs)
-                if (elm.covers(query[i])){
-                    *p = query[i];
+                if (elm.covers(query.descAt(i))){
+                    *p = query.descAt(i);
                     new_elm.copyMeta(elm);
                     resp.descs[i]=new_elm;
                     count++;
@@ -380,7 +624,7 @@ nixl_status_t nixlDescList<T>::populate (const nixlDescList<nixlBasicDesc> &quer
 
             while (q_index<query.descCount()){
                 s = &descs[s_index];
-                q = &query[q_index];
+                q = &query.descAt(q_index);
                 if ((*s).covers(*q)) {
                     *p = *q;
                     new_elm.copyMeta(descs[s_index]); // needs const nixlBasicDesc&
@@ -402,7 +646,7 @@ nixl_status_t nixlDescList<T>::populate (const nixlDescList<nixlBasicDesc> &quer
         } else {
             for (int i=0; i<query.descCount(); ++i) {
                 found = false;
-                q = &query[i];
+                q = &query.descAt(i);
                 auto itr = std::lower_bound(descs.begin() + last_found,
                                             descs.end(), *q, desc_comparator_f);
 
@@ -471,6 +715,28 @@ int nixlDescList<T>::getIndex(const nixlBasicDesc &query) const {
     return NIXL_ERR_NOT_FOUND;
 }
 
+template <class T>
+int nixlDescList<T>::getCoverIndex(const nixlBasicDesc &query) const {
+    if (!sorted) {
+        for (size_t i=0; i<descs.size(); ++i)
+            if (descs[i].covers(query))
+                return i;
+    } else {
+        // Last descriptor that starts at or before the query
+        auto itr = std::upper_bound(descs.begin(), descs.end(),
+                                    query, desc_comparator_f);
+        while (itr != descs.begin()) {
+            itr = std::prev(itr, 1);
+            if ((*itr).covers(query))
+                return itr - descs.begin();
+            // Several can start at the query address, check all of them
+            if (descAddrCompare(*itr, query, unifiedAddr))
+                break;
+        }
+    }
+    return NIXL_ERR_NOT_FOUND;
+}
+
 template <class T>
 nixl_status_t nixlDescList<T>::serialize(nixlSerDes* serializer) const {
 
@@ -505,7 +771,12 @@ nixl_status_t nixlDescList<T>::serialize(nixlSerDes* serializer) const {
     if (n_desc==0)
         return NIXL_SUCCESS; // Unusual, but supporting it
 
-    if (std::is_same<nixlBasicDesc, T>::value) {
+    if (serializer->descCompression()) {
+        std::string encoded;
+        encodeDescs(descs, encoded);
+        ret = serializer->addStr("", encoded);
+        if (ret) return ret;
+    } else if (std::is_same<nixlBasicDesc, T>::value) {
         // Contiguous in memory, so no need for per elm serialization
         ret = serializer->addStr("", std::string(
                                  reinterpret_cast<const char*>(descs.data()),
@@ -550,6 +821,7 @@ bool operator==(const nixlDescList<T> &lhs, const nixlDescList<T> &rhs) {
 template class nixlDescList<nixlBasicDesc>;
 template class nixlDescList<nixlMetaDesc>;
 template class nixlDescList<nixlStringDesc>;
+template class nixlDescList<nixlStridedDesc>;
 
 template bool operator==<nixlBasicDesc> (const nixlDescList<nixlBasicDesc> &lhs,
                                          const nixlDescList<nixlBasicDesc> &rhs);
@@ -557,3 +829,19 @@ template bool operator==<nixlMetaDesc>  (const nixlDescList<nixlMetaDesc> &lhs,
                                          const nixlDescList<nixlMetaDesc> &rhs);
 template bool operator==<nixlStringDesc>(const nixlDescList<nixlStringDesc> &lhs,
                                          const nixlDescList<nixlStringDesc> &rhs);
+template bool operator==<nixlStridedDesc>(const nixlDescList<nixlStridedDesc> &lhs,
+                                          const nixlDescList<nixlStridedDesc> &rhs);
+
+/*** Class nixlNotifArena implementation ***/
+
+void nixlNotifArena::append(const nixlNotifArena &other) {
+    size_t base = data.size();
+    data.append(other.data);
+    for (auto & rec : other.recs) {
+        const std::string &name = other.agents[rec.agentId];
+        nixl_notif_rec_t moved = rec;
+        moved.agentId = agentId(name.data(), name.size());
+        moved.offset += base;
+        recs.push_back(moved);
+    }
+}
@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 #include <map>
+#include <algorithm>
+#include <climits>
 #include "nixl.h"
 #include "nixl_descriptors.h"
 #include "internal/mem_section.h"
@@ -40,6 +42,95 @@ nixl_status_t nixlMemSection::populate (const nixl_xfer_dlist_t &query,
         return it->second->populate(query, resp);
 }
 
+nixl_status_t nixlMemSection::populate (const nixl_strided_dlist_t &query,
+                                        const nixl_backend_t &nixl_backend,
+                                        nixl_meta_dlist_t &resp) const {
+
+    if ((query.getType() != resp.getType()) || resp.isSorted())
+        return NIXL_ERR_INVALID_PARAM;
+    section_key_t sec_key = std::make_pair(query.getType(), nixl_backend);
+    auto it = sectionMap.find(sec_key);
+    if (it==sectionMap.end())
+        return NIXL_ERR_NOT_FOUND;
+    const nixl_meta_dlist_t &target = *it->second;
+
+    // Bounded so neither the total nor the resize can go wrong
+    size_t total = 0;
+    for (auto & elm : query) {
+        if (!elm.validExtent() || (elm.count > (size_t) INT_MAX - total)) {
+            resp.clear();
+            return NIXL_ERR_INVALID_PARAM;
+        }
+        total += elm.count;
+    }
+    resp.resize(total);
+
+    nixlMetaDesc out;
+    size_t pos = 0;
+
+    for (auto & elm : query) {
+        // One lookup for all elements, they should be in one registration
+        int index = target.getCoverIndex(elm.extent());
+        if (index<0) {
+            resp.clear();
+            return NIXL_ERR_UNKNOWN;
+        }
+        out.len   = elm.len;
+        out.devId = elm.devId;
+        out.copyMeta(target.descAt(index));
+        for (size_t i=0; i<elm.count; ++i) {
+            out.addr = elm.addr + i * elm.stride;
+            resp.descAt(pos++) = out;
+        }
+    }
+    return NIXL_SUCCESS;
+}
+
+template <class Q>
+nixlBackendEngine* nixlMemSection::findQueryT(
+                       const Q &query,
+                       const nixl_mem_t &remote_nixl_mem,
+                       const backend_set_t &remote_backends,
+                       nixl_meta_dlist_t &resp) const {
+
+    nixl_mem_t q_mem = query.getType();
+    if (q_mem>FILE_SEG)
+        return nullptr;
+
+    const backend_set_t* backend_set = &memToBackendMap.at(q_mem);
+    if (backend_set->empty())
+        return nullptr;
+
+    // Decision making based on supported local backends for this
+    // memory type, supported remote backends and remote memory type
+    // or here we loop through and find first local match. The more
+    // complete option (overkill) is to try all possible scenarios and
+    // see which populates on both side are successful and then decide
+
+    for (auto & elm : *backend_set) {
+        // If populate fails, it clears the resp before return
+        if (populate(query, elm, resp) == NIXL_SUCCESS)
+            return backendToEngineMap.at(elm);
+    }
+    return nullptr;
+}
+
+nixlBackendEngine* nixlMemSection::findQuery(
+                       const nixl_xfer_dlist_t &query,
+                       const nixl_mem_t &remote_nixl_mem,
+                       const backend_set_t &remote_backends,
+                       nixl_meta_dlist_t &resp) const {
+    return findQueryT(query, remote_nixl_mem, remote_backends, resp);
+}
+
+nixlBackendEngine* nixlMemSection::findQuery(
+                       const nixl_strided_dlist_t &query,
+                       const nixl_mem_t &remote_nixl_mem,
+                       const backend_set_t &remote_backends,
+                       nixl_meta_dlist_t &resp) const {
+    return findQueryT(query, remote_nixl_mem, remote_backends, resp);
+}
+
 /*** Class nixlLocalSection implementation ***/
 
 nixl_reg_dlist_t nixlLocalSection::getStringDesc (
@@ -92,12 +183,16 @@ nixl_status_t nixlLocalSection::addDescList (const nixl_reg_dlist_t &mem_elms,
     }
     nixl_meta_dlist_t *target = sectionMap[sec_key];
 
-    // Add entries to the target list
+    // Add entries to the target list, in one pass after all are registered
     nixlMetaDesc local_meta, self_meta;
     nixlBasicDesc *lp = &local_meta;
     nixlBasicDesc *rp = &self_meta;
     nixl_status_t ret1, ret2=NIXL_SUCCESS;
-    int index;
+    std::vector<nixlMetaDesc> local_descs, self_descs;
+
+    local_descs.reserve(mem_elms.descCount());
+    if (backend->supportsLocal())
+        self_descs.reserve(mem_elms.descCount());
 
     for (int i=0; i<mem_elms.descCount(); ++i) {
         // TODO: For now trusting the user, but there can be a more checks mode
@@ -109,11 +204,17 @@ nixl_status_t nixlLocalSection::addDescList (const nixl_reg_dlist_t &mem_elms,
         }
 
         if ((ret1!=NIXL_SUCCESS) || (ret2!=NIXL_SUCCESS)) {
-            for (int j=0; j<i; ++j) {
-                index = target->getIndex(mem_elms[j]);
-                backend->deregisterMem
-                    ((*(const nixl_meta_dlist_t*)target)[index].metadataP);
-                target->remDesc(index);
+            // Nothing was added to target yet, only the backend has state
+            for (auto & elm : self_descs)
+                backend->unloadMD(elm.metadataP);
+            for (auto & elm : local_descs)
+                backend->deregisterMem(elm.metadataP);
+            if (ret1==NIXL_SUCCESS)
+                backend->deregisterMem(local_meta.metadataP);
+            if (target->descCount()==0) {
+                delete target;
+                sectionMap.erase(sec_key);
+                memToBackendMap[nixl_mem].erase(nixl_backend);
             }
             remote_self.clear();
             if (ret1!=NIXL_SUCCESS)
@@ -126,13 +227,16 @@ nixl_status_t nixlLocalSection::addDescList (const nixl_reg_dlist_t &mem_elms,
         if ((nixl_mem == FILE_SEG) && (lp->len==0))
             lp->len = SIZE_MAX; // File has no range limit
 
-        target->addDesc(local_meta);
+        local_descs.push_back(local_meta);
 
         if (backend->supportsLocal()) {
             *rp = *lp;
-            remote_self.addDesc(self_meta);
+            self_descs.push_back(self_meta);
         }
     }
+
+    target->addDescs(local_descs);
+    remote_self.addDescs(self_descs);
     return NIXL_SUCCESS;
 }
 
@@ -148,20 +252,31 @@ nixl_status_t nixlLocalSection::remDescList (const nixl_meta_dlist_t &mem_elms,
     if (it==sectionMap.end())
         return NIXL_ERR_NOT_FOUND;
     nixl_meta_dlist_t *target = it->second;
+    const nixl_meta_dlist_t *c_target = target;
+    std::vector<int> indices;
+    std::vector<bool> taken(target->descCount(), false);
+    indices.reserve(mem_elms.descCount());
 
+    // Find all the entries first, so an error leaves everything registered
     for (auto & elm : mem_elms) {
         int index = target->getIndex(elm);
-        // Errorful situation, not sure helpful to deregister the rest,
-        // registering back what was deregistered is not meaningful.
-        // Can be secured by going through all the list then deregister
         if (index<0)
             return NIXL_ERR_UNKNOWN;
-
-        backend->deregisterMem
-            ((*(const nixl_meta_dlist_t*)target)[index].metadataP);
-        target->remDesc(index);
+        // Same region registered more than once, take the next copy
+        while (taken[index]) {
+            index++;
+            if ((index==target->descCount()) ||
+                ((nixlBasicDesc) (*c_target)[index] != (nixlBasicDesc) elm))
+                return NIXL_ERR_UNKNOWN;
+        }
+        taken[index] = true;
+        indices.push_back(index);
     }
 
+    for (auto & index : indices)
+        backend->deregisterMem((*c_target)[index].metadataP);
+    target->remDescs(indices);
+
     if (target->descCount()==0){
         delete target;
         sectionMap.erase(sec_key);
@@ -171,34 +286,6 @@ nixl_status_t nixlLocalSection::remDescList (const nixl_meta_dlist_t &mem_elms,
     return NIXL_SUCCESS;
 }
 
-nixlBackendEngine* nixlLocalSection::findQuery(
-                       const nixl_xfer_dlist_t &query,
-                       const nixl_mem_t &remote_nixl_mem,
-                       const backend_set_t &remote_backends,
-                       nixl_meta_dlist_t &resp) const {
-
-    nixl_mem_t q_mem = query.getType();
-    if (q_mem>FILE_SEG)
-        return nullptr;
-
-    const backend_set_t* backend_set = &memToBackendMap.at(q_mem);
-    if (backend_set->empty())
-        return nullptr;
-
-    // Decision making based on supported local backends for this
-    // memory type, supported remote backends and remote memory type
-    // or here we loop through and find first local match. The more
-    // complete option (overkill) is to try all possible scenarios and
-    // see which populates on both side are successful and then decide
-
-    for (auto & elm : *backend_set) {
-        // If populate fails, it clears the resp before return
-        if (populate(query, elm, resp) == NIXL_SUCCESS)
-            return backendToEngineMap.at(elm);
-    }
-    return nullptr;
-}
-
 nixl_status_t nixlLocalSection::serialize(nixlSerDes* serializer) const {
     nixl_status_t ret;
     size_t seg_count = sectionMap.size();
@@ -229,6 +316,35 @@ nixlLocalSection::~nixlLocalSection() {
         remDescList(*seg.second, backendToEngineMap[seg.first.second]);
 }
 
+/*** Class nixlSectionView implementation ***/
+
+void nixlSectionView::copyFrom (const nixlLocalSection &section) {
+    memToBackendMap    = section.memToBackendMap;
+    backendToEngineMap = section.backendToEngineMap;
+
+    // Lists of the previous copy keep their storage if still there
+    for (auto &seg : section.sectionMap) {
+        auto it = sectionMap.find(seg.first);
+        if (it == sectionMap.end())
+            sectionMap[seg.first] = new nixl_meta_dlist_t(*seg.second);
+        else
+            *it->second = *seg.second;
+    }
+    for (auto it = sectionMap.begin(); it != sectionMap.end();) {
+        if (section.sectionMap.count(it->first) == 0) {
+            delete it->second;
+            it = sectionMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+nixlSectionView::~nixlSectionView() {
+    for (auto &seg : sectionMap)
+        delete seg.second;
+}
+
 /*** Class nixlRemoteSection implementation ***/
 
 nixlRemoteSection::nixlRemoteSection (
@@ -236,10 +352,23 @@ nixlRemoteSection::nixlRemoteSection (
                    backend_map_t &engine_map) {
     this->agentName    = agent_name;
     backendToEngineMap = engine_map;
+    ownsMD             = true;
+}
+
+nixlRemoteSection::nixlRemoteSection (const nixlRemoteSection* prev) {
+    agentName          = prev->agentName;
+    memToBackendMap    = prev->memToBackendMap;
+    backendToEngineMap = prev->backendToEngineMap;
+    for (auto &seg : prev->sectionMap)
+        sectionMap[seg.first] = new nixl_meta_dlist_t(*seg.second);
+    for (auto &seg : prev->packedMap)
+        packedMap[seg.first] = new nixl_reg_dlist_t(*seg.second);
+    ownsMD             = prev->ownsMD;
 }
 
+// The packed metaInfo strings are moved out of mem_elms
 nixl_status_t nixlRemoteSection::addDescList (
-                                 const nixl_reg_dlist_t& mem_elms,
+                                 nixl_reg_dlist_t& mem_elms,
                                  nixlBackendEngine* backend) {
     if (!backend->supportsRemote())
         return NIXL_ERR_UNKNOWN;
@@ -253,30 +382,138 @@ nixl_status_t nixlRemoteSection::addDescList (
     if (sectionMap.count(sec_key) == 0)
         sectionMap[sec_key] = new nixl_meta_dlist_t(
                                   nixl_mem, mem_elms.isUnifiedAddr(), true);
+    if (packedMap.count(sec_key) == 0)
+        packedMap[sec_key] = new nixl_reg_dlist_t(
+                                 nixl_mem, mem_elms.isUnifiedAddr(), true);
     memToBackendMap[nixl_mem].insert(nixl_backend); // Fine to overwrite, it's a set
     nixl_meta_dlist_t *target = sectionMap[sec_key];
+    nixl_reg_dlist_t  *packed = packedMap[sec_key];
 
-
-    // Add entries to the target list.
+    // Add entries to the target list. Backend metadata is loaded on first use
+    // in populate, as usually only a small part of a remote agent is accessed.
     nixlMetaDesc out;
     nixlBasicDesc *p = &out;
-    nixl_status_t ret;
-    for (int i=0; i<mem_elms.descCount(); ++i) {
+    std::vector<nixlMetaDesc>   new_descs;
+    std::vector<nixlStringDesc> new_packed;
+    new_descs.reserve(mem_elms.descCount());
+    new_packed.reserve(mem_elms.descCount());
+    out.metadataP = nullptr;
+
+    // Visited in order of devId, addr and len, so repeats within mem_elms are
+    // next to each other and only the first is kept, as for ones in target
+    std::vector<int> order(mem_elms.descCount());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&mem_elms] (int a, int b) {
+        const nixlStringDesc &x = mem_elms.descAt(a), &y = mem_elms.descAt(b);
+        if (x.devId != y.devId)
+            return x.devId < y.devId;
+        if (x.addr != y.addr)
+            return x.addr < y.addr;
+        return x.len < y.len;
+    });
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        nixlStringDesc &elm = mem_elms.descAt(order[i]);
+        if ((i > 0) && ((const nixlBasicDesc) elm ==
+                        (const nixlBasicDesc) mem_elms.descAt(order[i-1])))
+            continue;
         // TODO: remote might change the metadata, have to keep stringDesc to compare
         //       if we support partial updates. Also Can add overlap checks (erroneous)
-        if (target->getIndex((const nixlBasicDesc) mem_elms[i]) < 0) {
-            ret = backend->loadRemoteMD(mem_elms[i], nixl_mem, agentName, out.metadataP);
-            // In case of errors, no need to remove the previous entries
-            // Agent will delete the full object.
-            if (ret<0)
-                return ret;
-            *p = mem_elms[i]; // Copy the basic desc part
-            target->addDesc(out);
+        if (target->getIndex((const nixlBasicDesc) elm) < 0) {
+            *p = elm; // Copy the basic desc part
+            new_descs.push_back(out);
+            new_packed.push_back(std::move(elm));
+        }
+    }
+    target->addDescs(new_descs);
+    packed->addDescs(new_packed);
+    return NIXL_SUCCESS;
+}
+
+// Loads the backend metadata of a descriptor in the section from its packed
+// form. Called with loadLock held, so only one thread loads each descriptor.
+nixl_status_t nixlRemoteSection::loadPacked (const section_key_t &sec_key,
+                                             const int &index) {
+    nixl_meta_dlist_t *target = sectionMap.at(sec_key);
+    nixl_reg_dlist_t  *packed = packedMap.at(sec_key);
+    nixlMetaDesc &elm = target->descAt(index);
+    nixlBackendMD* md;
+
+    if (elm.metadataP != nullptr) // Loaded by another thread meanwhile
+        return NIXL_SUCCESS;
+
+    int p_index = packed->getIndex(elm);
+    if (p_index<0)
+        return NIXL_ERR_NOT_FOUND;
+
+    nixlStringDesc &p_elm = packed->descAt(p_index);
+    nixl_status_t ret = backendToEngineMap.at(sec_key.second)->loadRemoteMD(
+                            p_elm, sec_key.first, agentName, md);
+    if (ret<0)
+        return ret;
+
+    // Readers check metadataP without the lock, they see either nullptr
+    // or the loaded metadata
+    __atomic_store_n(&elm.metadataP, md, __ATOMIC_RELEASE);
+    // Not needed anymore, only free the string to avoid reordering the list
+    std::string().swap(p_elm.metaInfo);
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t nixlRemoteSection::loadResp (const section_key_t &sec_key,
+                                           nixl_meta_dlist_t &resp) {
+    if (packedMap.count(sec_key) == 0) // Local data, everything is loaded
+        return NIXL_SUCCESS;
+    nixl_meta_dlist_t *target = sectionMap.at(sec_key);
+    nixlBackendMD* md = nullptr;
+    int index = -1;
+    nixl_status_t ret;
+
+    for (auto & elm : resp) {
+        if (elm.metadataP != nullptr)
+            continue;
+        // Often the same as the previous one, e.g., elements of a strided desc
+        if ((index<0) || !target->descAt(index).covers(elm)) {
+            index = target->getCoverIndex(elm);
+            if (index<0) { // Shouldn't happen, populate found it
+                resp.clear();
+                return NIXL_ERR_UNKNOWN;
+            }
+            md = __atomic_load_n(&target->descAt(index).metadataP, __ATOMIC_ACQUIRE);
+            if (md == nullptr) {
+                std::lock_guard<std::mutex> guard(loadLock);
+                ret = loadPacked(sec_key, index);
+                if (ret<0) {
+                    resp.clear();
+                    return ret;
+                }
+                md = target->descAt(index).metadataP;
+            }
         }
+        elm.metadataP = md;
     }
     return NIXL_SUCCESS;
 }
 
+nixl_status_t nixlRemoteSection::populate (const nixl_xfer_dlist_t &query,
+                                           const nixl_backend_t &nixl_backend,
+                                           nixl_meta_dlist_t &resp) {
+    nixl_status_t ret = nixlMemSection::populate(query, nixl_backend, resp);
+    if (ret!=NIXL_SUCCESS)
+        return ret;
+    return loadResp(std::make_pair(query.getType(), nixl_backend), resp);
+}
+
+nixl_status_t nixlRemoteSection::populate (const nixl_strided_dlist_t &query,
+                                           const nixl_backend_t &nixl_backend,
+                                           nixl_meta_dlist_t &resp) {
+    nixl_status_t ret = nixlMemSection::populate(query, nixl_backend, resp);
+    if (ret!=NIXL_SUCCESS)
+        return ret;
+    return loadResp(std::make_pair(query.getType(), nixl_backend), resp);
+}
+
 nixl_status_t nixlRemoteSection::loadRemoteData (nixlSerDes* deserializer) {
     nixl_status_t ret;
     size_t seg_count;
@@ -317,8 +554,7 @@ nixl_status_t nixlRemoteSection::loadLocalData (
     memToBackendMap[nixl_mem].insert(nixl_backend); // Fine to overwrite, it's a set
     nixl_meta_dlist_t *target = sectionMap[sec_key];
 
-    for (auto & elm: mem_elms)
-        target->addDesc(elm);
+    target->addDescs(mem_elms);
 
     if(backendToEngineMap.count(nixl_backend)==0)
         backendToEngineMap[nixl_backend]=backend;
@@ -333,9 +569,13 @@ nixlRemoteSection::~nixlRemoteSection() {
     for (auto &seg : sectionMap) {
         nixl_backend = seg.first.second;
         m_desc = seg.second;
-        for (auto & elm : *m_desc)
-            backendToEngineMap[nixl_backend]->unloadMD(elm.metadataP);
+        if (ownsMD)
+            for (auto & elm : *m_desc)
+                if (elm.metadataP != nullptr) // Not loaded if never used
+                    backendToEngineMap[nixl_backend]->unloadMD(elm.metadataP);
         delete m_desc;
     }
+    for (auto &seg : packedMap)
+        delete seg.second;
     // nixlMemSection destructor will clean up the rest
 }
@@ -17,6 +17,7 @@
 #include "ucx_backend.h"
 #include "serdes.h"
 #include <cassert>
+#include <algorithm>
 
 class nixlUcxCudaCtx {
 public:
@@ -178,17 +179,16 @@ void nixlUcxEngine::vramFiniCtx()
  * UCX request management
 *****************************************/
 
-void nixlUcxEngine::_requestInit(void *request)
+void nixlUcxEngine::_opCompleteCb(void *request, ucs_status_t status, void *user_data)
 {
-    /* Initialize request in-place (aka "placement new")*/
-    new(request) nixlUcxBckndReq;
-}
+    nixlUcxBckndReq *req = (nixlUcxBckndReq*)user_data;
 
-void nixlUcxEngine::_requestFini(void *request)
-{
-    /* Finalize request */
-    nixlUcxBckndReq *req = (nixlUcxBckndReq*)request;
-    req->~nixlUcxBckndReq();
+    if (status != UCS_OK) {
+        nixl_status_t expected = NIXL_SUCCESS;
+        req->status.compare_exchange_strong(expected, NIXL_ERR_BACKEND);
+    }
+    req->release();
+    nixlUcxWorker::reqRelease(request);
 }
 
 
@@ -199,17 +199,14 @@ void nixlUcxEngine::_requestFini(void *request)
 void nixlUcxEngine::progressFunc()
 {
     using namespace nixlTime;
+    pthrId = std::this_thread::get_id();
     pthrActive = 1;
 
     vramApplyCtx();
 
     while (!pthrStop) {
-        int i;
-        for(i = 0; i < noSyncIters; i++) {
-            uw->progress();
-        }
-        notifProgress();
-        // TODO: once NIXL thread infrastructure is available - move it there!!!
+        pthrRound();
+        // The agent can run this loop instead, see agentProgTh
 
         // {
         //     static uint64_t cnt = 0;
@@ -227,13 +224,42 @@ void nixlUcxEngine::progressFunc()
     }
 }
 
+int nixlUcxEngine::pthrRound()
+{
+    int i, ret = 0;
+
+    if (pthrCtxStale.load(std::memory_order_relaxed)) {
+        pthrCtxStale = false;
+        vramApplyCtx();
+    }
+
+    connProgress();
+    for(i = 0; i < noSyncIters; i++) {
+        ret += uw->progress();
+    }
+    notifProgress();
+
+    return ret;
+}
+
+void nixlUcxEngine::pthrAttach()
+{
+    pthrId = std::this_thread::get_id();
+    vramApplyCtx();
+}
+
+bool nixlUcxEngine::pthrArm()
+{
+    return (pthrEfd >= 0) && (uw->arm() == 0);
+}
+
 void nixlUcxEngine::progressThreadStart()
 {
     pthrStop = pthrActive = 0;
     noSyncIters = 32;
 
-    if (!pthrOn) {
-        // not enabled
+    if (!pthrOn || pthrAgent) {
+        // not enabled, or run by the agent
         return;
     }
 
@@ -249,17 +275,24 @@ void nixlUcxEngine::progressThreadStart()
 
 void nixlUcxEngine::progressThreadStop()
 {
-    if (!pthrOn) {
-        // not enabled
+    if (!pthrOn || pthrAgent) {
+        // not enabled, or run by the agent
         return;
     }
 
     pthrStop = 1;
     pthr.join();
+    pthrId = std::thread::id();
 }
 
 void nixlUcxEngine::progressThreadRestart()
 {
+    if (pthrAgent) {
+        // Can't restart the agent's thread, it picks up the new context
+        pthrCtxStale = true;
+        return;
+    }
+
     progressThreadStop();
     progressThreadStart();
 }
@@ -272,6 +305,7 @@ nixlUcxEngine::nixlUcxEngine (const nixlBackendInitParams* init_params)
 : nixlBackendEngine (init_params) {
     std::vector<std::string> devs; /* Empty vector */
     uint64_t                 n_addr;
+    size_t                   num_eps = 3;
     nixl_b_params_t* custom_params = init_params->customParams;
 
     if (init_params->enableProgTh) {
@@ -284,15 +318,95 @@ nixlUcxEngine::nixlUcxEngine (const nixlBackendInitParams* init_params)
     if (custom_params->count("device_list")!=0)
         devs = str_split((*custom_params)["device_list"], ", ");
 
-    uc = new nixlUcxContext(devs, sizeof(nixlUcxBckndReq),
-                           _requestInit, _requestFini, NIXL_UCX_MT_WORKER);
+    lazyConnect = (custom_params->count("lazy_connect")!=0) &&
+                  ((*custom_params)["lazy_connect"] == "true");
+
+    iovGather = (custom_params->count("iov_gather")!=0) &&
+                ((*custom_params)["iov_gather"] == "true");
+
+    lazyFlush = false;
+    if (custom_params->count("flush_mode")!=0) {
+        const std::string &mode = (*custom_params)["flush_mode"];
+        if (mode == "lazy") {
+            lazyFlush = true;
+        } else if (mode != "always") {
+            this->initErr = true;
+            return;
+        }
+    }
+
+    dramMaxLen = 0;
+
+    // Largest last descriptor of a WR_NOTIF sent inside the notification
+    notifInline = 0;
+    if (custom_params->count("notif_inline")!=0) {
+        char *end;
+        const std::string &val = (*custom_params)["notif_inline"];
+        notifInline = strtoul(val.c_str(), &end, 10);
+        if (val.empty() || (*end != '\0') || (notifInline > NOTIF_EAGER_MAX)) {
+            this->initErr = true;
+            return;
+        }
+    }
+
+    // Expected number of remote agents, so UCX can size its endpoint tables
+    if (custom_params->count("num_eps")!=0) {
+        char *end;
+        const std::string &val = (*custom_params)["num_eps"];
+        num_eps = strtoul(val.c_str(), &end, 10);
+        if (val.empty() || (*end != '\0') || (num_eps == 0)) {
+            this->initErr = true;
+            return;
+        }
+    }
+
+    // Keepalive interval, and how long a peer may leave one unacknowledged
+    keepaliveUs = 0;
+    if (custom_params->count("keepalive_ms")!=0) {
+        char *end;
+        const std::string &val = (*custom_params)["keepalive_ms"];
+        keepaliveUs = strtoul(val.c_str(), &end, 10) * 1000;
+        if (val.empty() || (*end != '\0')) {
+            this->initErr = true;
+            return;
+        }
+    }
+
+    peerTimeoutUs = 10 * keepaliveUs;
+    if (custom_params->count("peer_timeout_ms")!=0) {
+        char *end;
+        const std::string &val = (*custom_params)["peer_timeout_ms"];
+        peerTimeoutUs = strtoul(val.c_str(), &end, 10) * 1000;
+        if (val.empty() || (*end != '\0') || (peerTimeoutUs == 0)) {
+            this->initErr = true;
+            return;
+        }
+    }
+    kaNext = 0;
+    connFailed = false;
+    failedReport = false;
+
+    // Wakeup only when the agent's thread waits on the worker, since it can
+    // leave out transports that don't support it
+    bool wakeup = init_params->enableProgTh && init_params->agentProgTh &&
+                  init_params->pthrWait;
+
+    // Ops are tracked by their completion callbacks, nothing kept in UCX requests
+    uc = new nixlUcxContext(devs, 0, NULL, NULL, NIXL_UCX_MT_WORKER, num_eps,
+                            wakeup);
     uw = new nixlUcxWorker(uc);
     uw->epAddr(n_addr, workerSize);
     workerAddr = (void*) n_addr;
 
+    pthrEfd = -1;
+    if (wakeup && uw->getEfd(pthrEfd))
+        pthrEfd = -1;
+
     uw->regAmCallback(CONN_CHECK, connectionCheckAmCb, this);
     uw->regAmCallback(DISCONNECT, connectionTermAmCb, this);
     uw->regAmCallback(NOTIF_STR, notifAmCb, this);
+    uw->regAmCallback(NOTIF_DATA, notifAmCb, this);
+    uw->regAmCallback(KEEPALIVE, keepaliveAmCb, this);
 
     if (init_params->enableProgTh) {
         pthrOn = true;
@@ -300,6 +414,12 @@ nixlUcxEngine::nixlUcxEngine (const nixlBackendInitParams* init_params)
     } else {
         pthrOn = false;
     }
+    pthrAgent = pthrOn && init_params->agentProgTh;
+    pthrId = std::thread::id();
+    pthrCtxStale = false;
+    notifCb = NULL;
+    notifCbArg = NULL;
+    notifCbOn = false;
 
     // Temp fixup
     if (getenv("NIXL_DISABLE_CUDA_ADDR_WA")) {
@@ -332,29 +452,59 @@ nixlUcxEngine::~nixlUcxEngine () {
  * Connection management
 *****************************************/
 
+ucx_connection_ptr_t nixlUcxEngine::getConn(const std::string &remote_agent) {
+    std::lock_guard<std::mutex> guard(connMtx);
+    auto search = remoteConnMap.find(remote_agent);
+
+    if(search == remoteConnMap.end()) {
+        return nullptr;
+    }
+    return search->second;
+}
+
 nixl_status_t nixlUcxEngine::checkConn(const std::string &remote_agent) {
-     if(remoteConnMap.find(remote_agent) == remoteConnMap.end()) {
+    if(!getConn(remote_agent)) {
         return NIXL_ERR_NOT_FOUND;
     }
     return NIXL_SUCCESS;
 }
 
 nixl_status_t nixlUcxEngine::endConn(const std::string &remote_agent) {
+    ucx_connection_ptr_t conn_ptr;
+    bool close_ep;
 
-    auto search = remoteConnMap.find(remote_agent);
+    {
+        std::lock_guard<std::mutex> guard(connMtx);
+        auto search = remoteConnMap.find(remote_agent);
 
-    if(search == remoteConnMap.end()) {
-        return NIXL_ERR_NOT_FOUND;
+        if(search == remoteConnMap.end()) {
+            return NIXL_ERR_NOT_FOUND;
+        }
+
+        conn_ptr = search->second;
+        remoteConnMap.erase(search);
+
+        // Metadata still holding the connection can't post on it anymore.
+        // Lazy connection that was never used has no ep, and a failed one
+        // is closed by connReap.
+        close_ep = !conn_ptr->closed && (conn_ptr->state != UCX_CONN_RECORDED);
+        conn_ptr->closed = true;
+        conn_ptr->failed = true;
     }
 
-    nixlUcxConnection &conn = remoteConnMap[remote_agent];
+    nixlUcxConnection &conn = *conn_ptr;
+    connDrain(conn);
 
-    if(uw->disconnect_nb(conn.ep) < 0) {
-        return NIXL_ERR_BACKEND;
+    std::lock_guard<std::mutex> guard(connMtx);
+    if(conn.state == UCX_CONN_CHECK_SENT) {
+        uw->reqCancel(conn.checkReq);
+        uw->reqRelease(conn.checkReq);
+        conn.checkReq = nullptr;
     }
 
-    //thread safety?
-    remoteConnMap.erase(remote_agent);
+    if(close_ep && (uw->disconnect_nb(conn.ep) < 0)) {
+        return NIXL_ERR_BACKEND;
+    }
 
     return NIXL_SUCCESS;
 }
@@ -413,18 +563,41 @@ nixlUcxEngine::connectionTermAmCb (void *arg, const void *header,
         //is this the best way to ERR?
         return UCS_ERR_INVALID_PARAM;
     }
-/*
-    // TODO: research UCX connection logic and fix.
-    nixlUcxEngine* engine = (nixlUcxEngine*) arg;
-    if(NIXL_SUCCESS != engine->endConn(remote_agent)) {
-        //TODO: received connect AM from agent we don't recognize
+
+    // The peer dropped our metadata, but its memory can still be accessed
+    // through our ep, so it's kept. A peer that goes away is found through
+    // ep errors and keepalives instead.
+    return UCS_OK;
+}
+
+ucs_status_t
+nixlUcxEngine::keepaliveAmCb(void *arg, const void *header,
+                             size_t header_length, void *data,
+                             size_t length,
+                             const ucp_am_recv_param_t *param)
+{
+    struct nixl_ucx_am_hdr* hdr = (struct nixl_ucx_am_hdr*) header;
+
+    // Nothing to do, the sender's flush behind it is the probe
+    if(hdr->op != KEEPALIVE) {
         return UCS_ERR_INVALID_PARAM;
     }
-*/
+
     return UCS_OK;
 }
 
 nixl_status_t nixlUcxEngine::connect(const std::string &remote_agent) {
+    nixl_status_t ret = connectAsync(remote_agent);
+
+    //wait for AM to send
+    while(ret == NIXL_IN_PROG){
+        ret = checkConnect(remote_agent);
+    }
+
+    return ret;
+}
+
+nixl_status_t nixlUcxEngine::connectAsync(const std::string &remote_agent) {
     struct nixl_ucx_am_hdr hdr;
     uint32_t flags = 0;
     nixl_status_t ret;
@@ -434,13 +607,36 @@ nixl_status_t nixlUcxEngine::connect(const std::string &remote_agent) {
         return loadRemoteConnInfo (remote_agent,
                    nixlSerDes::_bytesToString(workerAddr, workerSize));
 
-    auto search = remoteConnMap.find(remote_agent);
+    ucx_connection_ptr_t conn_ptr = getConn(remote_agent);
 
-    if(search == remoteConnMap.end()) {
+    if(!conn_ptr) {
         return NIXL_ERR_NOT_FOUND;
     }
 
-    nixlUcxConnection &conn = remoteConnMap[remote_agent];
+    nixlUcxConnection &conn = *conn_ptr;
+    nixlUcxConnGuard conn_guard;
+
+    // A peer found dead isn't retried, its metadata has to be reloaded
+    if(!conn_guard.enter(&conn)) {
+        return NIXL_ERR_BACKEND;
+    }
+
+    switch(conn.state) {
+        case UCX_CONN_ESTABLISHED:
+            return NIXL_SUCCESS;
+        case UCX_CONN_CHECK_SENT:
+            return NIXL_IN_PROG;
+        default: // Loaded, or retry after a failed check
+            break;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(connMtx);
+        ret = connCreateEp(conn);
+    }
+    if(ret < 0) {
+        return ret;
+    }
 
     hdr.op = CONN_CHECK;
     //agent names should never be long enough to need RNDV
@@ -452,17 +648,59 @@ nixl_status_t nixlUcxEngine::connect(const std::string &remote_agent) {
                      flags, req);
 
     if(ret < 0) {
+        conn.state = UCX_CONN_FAILED;
         return ret;
     }
 
-    //wait for AM to send
-    while(ret == NIXL_IN_PROG){
-        ret = uw->test(req);
+    if(ret == NIXL_IN_PROG) {
+        conn.state    = UCX_CONN_CHECK_SENT;
+        conn.checkReq = req;
+        return NIXL_IN_PROG;
     }
 
+    conn.state = UCX_CONN_ESTABLISHED;
     return NIXL_SUCCESS;
 }
 
+nixl_status_t nixlUcxEngine::checkConnect(const std::string &remote_agent) {
+    nixl_status_t ret;
+
+    ucx_connection_ptr_t conn_ptr = getConn(remote_agent);
+
+    if(!conn_ptr) {
+        return NIXL_ERR_NOT_FOUND;
+    }
+
+    nixlUcxConnection &conn = *conn_ptr;
+
+    // Connection to self is established once loaded
+    if (remote_agent == localAgent)
+        return NIXL_SUCCESS;
+
+    switch(conn.state) {
+        case UCX_CONN_ESTABLISHED:
+            return NIXL_SUCCESS;
+        case UCX_CONN_FAILED:
+            return NIXL_ERR_BACKEND;
+        case UCX_CONN_RECORDED:
+        case UCX_CONN_LOADED:
+            return NIXL_ERR_NOT_POSTED;
+        case UCX_CONN_CHECK_SENT:
+            break;
+    }
+
+    // Progresses the worker, so all connects in flight move forward
+    ret = uw->test(conn.checkReq);
+    if(ret == NIXL_IN_PROG) {
+        return NIXL_IN_PROG;
+    }
+
+    uw->reqRelease(conn.checkReq);
+    conn.checkReq = nullptr;
+    conn.state = (ret == NIXL_SUCCESS) ? UCX_CONN_ESTABLISHED : UCX_CONN_FAILED;
+    return ret;
+}
+
 nixl_status_t nixlUcxEngine::disconnect(const std::string &remote_agent) {
 
     static struct nixl_ucx_am_hdr hdr;
@@ -471,26 +709,31 @@ nixl_status_t nixlUcxEngine::disconnect(const std::string &remote_agent) {
     nixlUcxReq req;
 
     if (remote_agent != localAgent) {
-        auto search = remoteConnMap.find(remote_agent);
+        ucx_connection_ptr_t conn_ptr = getConn(remote_agent);
 
-        if(search == remoteConnMap.end()) {
+        if(!conn_ptr) {
             return NIXL_ERR_NOT_FOUND;
         }
 
-        nixlUcxConnection &conn = remoteConnMap[remote_agent];
+        nixlUcxConnection &conn = *conn_ptr;
+        nixlUcxConnGuard conn_guard;
 
         hdr.op = DISCONNECT;
         //agent names should never be long enough to need RNDV
         flags |= UCP_AM_SEND_FLAG_EAGER;
 
-        ret = uw->sendAm(conn.ep, DISCONNECT,
-                        &hdr, sizeof(struct nixl_ucx_am_hdr),
-                        (void*) localAgent.data(), localAgent.size(),
-                        flags, req);
-
-        //don't care
-        if(ret == NIXL_IN_PROG){
-            uw->reqRelease(req);
+        //lazy connection that was never used, the peer doesn't know us,
+        //and a failed one can't be sent on
+        if(conn_guard.enter(&conn) && (conn.state != UCX_CONN_RECORDED)) {
+            ret = uw->sendAm(conn.ep, DISCONNECT,
+                            &hdr, sizeof(struct nixl_ucx_am_hdr),
+                            (void*) localAgent.data(), localAgent.size(),
+                            flags, req);
+
+            //don't care
+            if(ret == NIXL_IN_PROG){
+                uw->reqRelease(req);
+            }
         }
     }
 
@@ -499,32 +742,53 @@ nixl_status_t nixlUcxEngine::disconnect(const std::string &remote_agent) {
     return NIXL_SUCCESS;
 }
 
+nixl_status_t nixlUcxEngine::connCreateEp(nixlUcxConnection &conn)
+{
+    if(conn.state != UCX_CONN_RECORDED) {
+        return NIXL_SUCCESS;
+    }
+
+    // ucp_ep_create doesn't wait for the peer, transfers posted right after
+    // are queued until wireup is done.
+    if(uw->connect((void*) conn.connInfo.data(), conn.connInfo.size(), conn.ep,
+                   connErrCb, &conn)) {
+        return NIXL_ERR_BACKEND;
+    }
+
+    conn.state = UCX_CONN_LOADED;
+    conn.connInfo.clear();
+    conn.connInfo.shrink_to_fit();
+
+    return NIXL_SUCCESS;
+}
+
 nixl_status_t nixlUcxEngine::loadRemoteConnInfo (const std::string &remote_agent,
                                                  const std::string &remote_conn_info)
 {
-    size_t size = remote_conn_info.size();
-    nixlUcxConnection conn;
-    int ret;
-    //TODO: eventually std::byte?
-    char* addr = new char[size];
+    ucx_connection_ptr_t conn;
+    nixl_status_t ret;
 
+    std::lock_guard<std::mutex> guard(connMtx);
     if(remoteConnMap.find(remote_agent) != remoteConnMap.end()) {
         return NIXL_ERR_INVALID_PARAM;
     }
 
-    nixlSerDes::_stringToBytes((void*) addr, remote_conn_info, size);
-    ret = uw->connect(addr, size, conn.ep);
-    if (ret) {
-        return NIXL_ERR_BACKEND;
-    }
+    conn = std::make_shared<nixlUcxConnection>();
+    conn->remoteAgent = remote_agent;
+    conn->connInfo = remote_conn_info;
+    conn->engine = this;
 
-    conn.remoteAgent = remote_agent;
-    conn.connected = false;
+    // In lazy mode the ep is created when connecting or on first transfer.
+    // Connection to self is always made, it's used for local metadata.
+    if(!lazyConnect || (remote_agent == localAgent)) {
+        ret = connCreateEp(*conn);
+        if(ret < 0) {
+            return ret;
+        }
+    }
 
     remoteConnMap[remote_agent] = conn;
 
-    delete[] addr;
-
     return NIXL_SUCCESS;
 }
 
@@ -561,6 +825,14 @@ nixl_status_t nixlUcxEngine::registerMem (const nixlStringDesc &mem,
     }
     priv->rkeyStr = nixlSerDes::_bytesToString((void*) rkey_addr, rkey_size);
 
+    if (nixl_mem == DRAM_SEG) {
+        std::lock_guard<std::mutex> guard(dramMtx);
+        priv->dramAddr = mem.addr;
+        priv->dramLen  = mem.len;
+        dramRegions.insert(std::make_pair(mem.addr, mem.addr + mem.len));
+        dramMaxLen = std::max(dramMaxLen, mem.len);
+    }
+
     out = (nixlBackendMD*) priv; //typecast?
 
     return NIXL_SUCCESS; // Or errors
@@ -570,6 +842,17 @@ void nixlUcxEngine::deregisterMem (nixlBackendMD* meta)
 {
     nixlUcxPrivateMetadata *priv = (nixlUcxPrivateMetadata*) meta; //typecast?
 
+    if (priv->dramAddr) {
+        std::lock_guard<std::mutex> guard(dramMtx);
+        auto range = dramRegions.equal_range(priv->dramAddr);
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second == priv->dramAddr + priv->dramLen) {
+                dramRegions.erase(it);
+                break;
+            }
+        }
+    }
+
     uw->memDereg(priv->mem);
     delete priv;
 }
@@ -581,31 +864,32 @@ std::string nixlUcxEngine::getPublicData (const nixlBackendMD* meta) const {
 
 nixl_status_t nixlUcxEngine::loadLocalMD (nixlBackendMD* input,
                                           nixlBackendMD* &output) {
-    nixlUcxConnection conn;
+    ucx_connection_ptr_t conn;
     nixlUcxPrivateMetadata* input_md = (nixlUcxPrivateMetadata*) input;
     nixlUcxPublicMetadata *md = new nixlUcxPublicMetadata;
 
     //look up our own name
-    auto search = remoteConnMap.find(localAgent);
+    conn = getConn(localAgent);
 
-    if(search == remoteConnMap.end()) {
+    if(!conn) {
         //TODO: something wrong, local connection should have been established
+        delete md;
         return NIXL_ERR_NOT_FOUND;
     }
-    conn = (nixlUcxConnection) search->second;
 
-    //directly copy underlying conn struct
+    //share the underlying conn struct
     md->conn = conn;
 
     size_t size = input_md->rkeyStr.size();
     char *addr = new char[size];
     nixlSerDes::_stringToBytes(addr, input_md->rkeyStr, size);
 
-    int ret = uw->rkeyImport(conn.ep, addr, size, md->rkey);
+    int ret = uw->rkeyImport(conn->ep, addr, size, md->rkey);
     if (ret) {
         // TODO: error out. Should we indicate which desc failed or unroll everything prior
         return NIXL_ERR_BACKEND;
     }
+    md->rkeyLoaded = true;
 
     output = (nixlBackendMD*) md;
 
@@ -619,33 +903,50 @@ nixl_status_t nixlUcxEngine::loadRemoteMD (const nixlStringDesc &input,
                                            const nixl_mem_t &nixl_mem,
                                            const std::string &remote_agent,
                                            nixlBackendMD* &output) {
-    size_t size = input.metaInfo.size();
-    char *addr = new char[size];
-    int ret;
-    nixlUcxConnection conn;
-
-    nixlUcxPublicMetadata *md = new nixlUcxPublicMetadata;
-
-    auto search = remoteConnMap.find(remote_agent);
+    ucx_connection_ptr_t conn = getConn(remote_agent);
 
-    if(search == remoteConnMap.end()) {
+    if(!conn) {
         //TODO: err: remote connection not found
         return NIXL_ERR_NOT_FOUND;
     }
-    conn = (nixlUcxConnection) search->second;
-
-    nixlSerDes::_stringToBytes(addr, input.metaInfo, size);
 
+    nixlUcxPublicMetadata *md = new nixlUcxPublicMetadata;
     md->conn = conn;
-    ret = uw->rkeyImport(conn.ep, addr, size, md->rkey);
-    if (ret) {
-        // TODO: error out. Should we indicate which desc failed or unroll everything prior
-        return NIXL_ERR_BACKEND;
+    md->rkeyStr = input.metaInfo;
+
+    // Unpacking needs the ep, so in lazy mode both are done on first use
+    if (!lazyConnect) {
+        nixl_status_t ret = rkeyUnpack(md);
+        if (ret) {
+            // TODO: error out. Should we indicate which desc failed or unroll everything prior
+            delete md;
+            return ret;
+        }
     }
     output = (nixlBackendMD*) md;
 
-    delete[] addr;
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t nixlUcxEngine::rkeyUnpack (nixlUcxPublicMetadata* md) {
+    nixl_status_t ret;
+
+    // Several threads can post with the same metadata
+    std::lock_guard<std::mutex> guard(connMtx);
+    if (md->rkeyLoaded)
+        return NIXL_SUCCESS;
+
+    ret = connCreateEp(*md->conn);
+    if (ret)
+        return ret;
+
+    if (uw->rkeyImport(md->conn->ep, (void*) md->rkeyStr.data(),
+                       md->rkeyStr.size(), md->rkey))
+        return NIXL_ERR_BACKEND;
 
+    md->rkeyLoaded = true;
+    md->rkeyStr.clear();
+    md->rkeyStr.shrink_to_fit();
     return NIXL_SUCCESS;
 }
 
@@ -653,7 +954,8 @@ nixl_status_t nixlUcxEngine::unloadMD (nixlBackendMD* input) {
 
     nixlUcxPublicMetadata *md = (nixlUcxPublicMetadata*) input; //typecast?
 
-    uw->rkeyDestroy(md->rkey);
+    if (md->rkeyLoaded)
+        uw->rkeyDestroy(md->rkey);
     delete md;
 
     return NIXL_SUCCESS;
@@ -663,39 +965,155 @@ nixl_status_t nixlUcxEngine::unloadMD (nixlBackendMD* input) {
  * Data movement
 *****************************************/
 
-nixl_status_t nixlUcxEngine::retHelper(nixl_status_t ret, nixlUcxBckndReq *head, nixlUcxReq &req)
+// An op was posted for handle, which took a reference for it beforehand
+nixl_status_t nixlUcxEngine::retHelper(nixl_status_t ret, nixlUcxBckndReq *handle)
 {
-    /* if transfer wasn't immediately completed */
     switch(ret) {
         case NIXL_IN_PROG:
-            head->link((nixlUcxBckndReq*)req);
+            // The completion callback drops the reference and frees req
             break;
         case NIXL_SUCCESS:
-            // Nothing to do
+            handle->release();
             break;
         default:
-            // Error. Release all previously initiated ops and exit:
-            if (head->next()) {
-                releaseReqH(head->next());
-            }
-            return NIXL_ERR_BACKEND;
+            handle->release();
+            return ret;
     }
     return NIXL_SUCCESS;
 }
 
+nixl_status_t nixlUcxEngine::postContig(const nixl_xfer_op_t &op,
+                                         const nixlMetaDesc &ldesc,
+                                         const nixlMetaDesc &rdesc,
+                                         nixlUcxBckndReq *handle)
+{
+    nixlUcxPrivateMetadata *lmd = (nixlUcxPrivateMetadata*) ldesc.metadataP;
+    nixlUcxPublicMetadata *rmd = (nixlUcxPublicMetadata*) rdesc.metadataP;
+    nixl_status_t ret;
+    nixlUcxReq req;
+
+    handle->hold();
+    switch (op) {
+    case NIXL_READ:
+    case NIXL_RD_NOTIF:
+        ret = uw->read(rmd->conn->ep, (uint64_t) rdesc.addr, rmd->rkey,
+                       (void*) ldesc.addr, lmd->mem, ldesc.len, req,
+                       _opCompleteCb, handle);
+        break;
+    case NIXL_WRITE:
+    case NIXL_WR_NOTIF:
+        ret = uw->write(rmd->conn->ep, (void*) ldesc.addr, lmd->mem,
+                        (uint64_t) rdesc.addr, rmd->rkey, ldesc.len, req,
+                        _opCompleteCb, handle);
+        break;
+    default:
+        ret = NIXL_ERR_INVALID_PARAM;
+    }
+    return retHelper(ret, handle);
+}
+
+// Descriptors [first, last) are back to back in one remote registration.
+// Local fragments that are contiguous in one registration are merged, and
+// what remains goes out as one iov op. NIXL_ERR_NOT_ALLOWED if iov RMA is
+// not supported and nothing was posted.
+nixl_status_t nixlUcxEngine::postGather(const nixl_xfer_op_t &op,
+                                        const nixlMetaDesc *ldesc,
+                                        const nixlMetaDesc *rdesc,
+                                        size_t first, size_t last,
+                                        nixlUcxBckndReq *handle)
+{
+    nixlUcxPublicMetadata *rmd = (nixlUcxPublicMetadata*) rdesc[first].metadataP;
+    std::vector<ucp_dt_iov_t> &iov = handle->iov;
+    size_t start = iov.size();
+    nixl_status_t ret;
+    nixlUcxReq req;
+
+    // Capacity was reserved for all descriptors, earlier lists stay in place
+    for (size_t i = first; i < last; i++) {
+        if ((iov.size() > start) &&
+            (ldesc[i].metadataP == ldesc[i-1].metadataP) &&
+            (ldesc[i].addr == (uintptr_t) iov.back().buffer + iov.back().length)) {
+            iov.back().length += ldesc[i].len;
+            continue;
+        }
+        ucp_dt_iov_t frag = { (void*) ldesc[i].addr, ldesc[i].len };
+        iov.push_back(frag);
+    }
+    size_t iov_cnt = iov.size() - start;
+
+    // Contiguous on both sides, the registration of the first covers it all
+    if (iov_cnt == 1) {
+        nixlMetaDesc ltotal = ldesc[first];
+        ltotal.len = iov[start].length;
+        iov.resize(start);
+        return postContig(op, ltotal, rdesc[first], handle);
+    }
+
+    if (!iovGather) {
+        iov.resize(start);
+        return NIXL_ERR_NOT_ALLOWED;
+    }
+
+    handle->hold();
+    switch (op) {
+    case NIXL_READ:
+    case NIXL_RD_NOTIF:
+        ret = uw->readv(rmd->conn->ep, (uint64_t) rdesc[first].addr, rmd->rkey,
+                        &iov[start], iov_cnt, req, _opCompleteCb, handle);
+        break;
+    case NIXL_WRITE:
+    case NIXL_WR_NOTIF:
+        ret = uw->writev(rmd->conn->ep, &iov[start], iov_cnt,
+                         (uint64_t) rdesc[first].addr, rmd->rkey, req,
+                         _opCompleteCb, handle);
+        break;
+    default:
+        ret = NIXL_ERR_INVALID_PARAM;
+    }
+
+    if (ret != NIXL_IN_PROG) {
+        iov.resize(start);
+        if (ret == NIXL_ERR_NOT_ALLOWED)
+            iovGather = false;
+    }
+    return retHelper(ret, handle);
+}
+
 nixl_status_t nixlUcxEngine::postXfer (const nixl_meta_dlist_t &local,
                                        const nixl_meta_dlist_t &remote,
                                        const nixl_xfer_op_t &op,
                                        const std::string &remote_agent,
                                        const std::string &notif_msg,
                                        nixlBackendReqH* &handle)
+{
+    return postXferPriv(local, remote, op, remote_agent, notif_msg, NULL, handle);
+}
+
+nixl_status_t nixlUcxEngine::postXferSignal (const nixl_meta_dlist_t &local,
+                                             const nixl_meta_dlist_t &remote,
+                                             const nixl_xfer_op_t &op,
+                                             const std::string &remote_agent,
+                                             const std::string &notif_msg,
+                                             const nixlMetaDesc &signal,
+                                             nixlBackendReqH* &handle)
+{
+    return postXferPriv(local, remote, op, remote_agent, notif_msg, &signal, handle);
+}
+
+nixl_status_t nixlUcxEngine::postXferPriv (const nixl_meta_dlist_t &local,
+                                           const nixl_meta_dlist_t &remote,
+                                           const nixl_xfer_op_t &op,
+                                           const std::string &remote_agent,
+                                           const std::string &notif_msg,
+                                           const nixlMetaDesc *signal,
+                                           nixlBackendReqH* &handle)
 {
     size_t lcnt = local.descCount();
     size_t rcnt = remote.descCount();
-    size_t i;
+    size_t i, last, post_cnt;
+    const nixlMetaDesc *inl_local = NULL, *inl_remote = NULL;
     nixl_status_t ret;
-    nixlUcxBckndReq dummy, *head = new (&dummy) nixlUcxBckndReq;
-    nixlUcxPrivateMetadata *lmd;
+    nixlUcxBckndReq *xfer;
     nixlUcxPublicMetadata *rmd;
     nixlUcxReq req;
 
@@ -704,190 +1122,417 @@ nixl_status_t nixlUcxEngine::postXfer (const nixl_meta_dlist_t &local,
         return NIXL_ERR_INVALID_PARAM;
     }
 
-    for(i = 0; i < lcnt; i++) {
-        void *laddr = (void*) local[i].addr;
-        size_t lsize = local[i].len;
-        void *raddr = (void*) remote[i].addr;
-        size_t rsize = remote[i].len;
+    switch (op) {
+    case NIXL_READ:
+    case NIXL_WRITE:
+    case NIXL_RD_NOTIF:
+    case NIXL_WR_NOTIF:
+        break;
+    default:
+        return NIXL_ERR_INVALID_PARAM;
+    }
+
+    const nixlMetaDesc *ldesc = local.data();
+    const nixlMetaDesc *rdesc = remote.data();
+
+    // The last descriptor may travel with the notification, unless the
+    // signal has to follow all the data. Only chosen when the target takes
+    // it: remote is DRAM the target registered with UCX, as populate found
+    // it in its metadata, and the AM is sent eager within NOTIF_EAGER_MAX.
+    post_cnt = lcnt;
+    if ((op == NIXL_WR_NOTIF) && !signal && (lcnt > 0) &&
+        (ldesc[lcnt-1].len <= notifInline) &&
+        (ldesc[lcnt-1].len + notif_msg.size() + localAgent.size() +
+         NOTIF_AM_OVERHEAD <= NOTIF_EAGER_MAX) &&
+        (local.getType() == DRAM_SEG) && (remote.getType() == DRAM_SEG)) {
+        if (ldesc[lcnt-1].len != rdesc[lcnt-1].len) {
+            return NIXL_ERR_INVALID_PARAM;
+        }
+        post_cnt   = lcnt - 1;
+        inl_local  = &ldesc[post_cnt];
+        inl_remote = &rdesc[post_cnt];
+    }
+
+    // All ops go to one agent, fail fast if it's dead. Only the notification
+    // is left otherwise, and it checks on its own.
+    nixlUcxConnGuard conn_guard;
+    rmd = (nixlUcxPublicMetadata*) (post_cnt ? rdesc[0].metadataP :
+                                    signal ? signal->metadataP : NULL);
+    if (rmd && !conn_guard.enter(rmd->conn.get())) {
+        return NIXL_ERR_BACKEND;
+    }
 
-        lmd = (nixlUcxPrivateMetadata*) local[i].metadataP;
-        rmd = (nixlUcxPublicMetadata*) remote[i].metadataP;
+    xfer = new nixlUcxBckndReq;
 
-        if (lsize != rsize) {
+    for(i = 0; i < post_cnt; i = last) {
+        rmd = (nixlUcxPublicMetadata*) rdesc[i].metadataP;
+
+        if (ldesc[i].len != rdesc[i].len) {
+            xfer->release();
             return NIXL_ERR_INVALID_PARAM;
         }
 
+        // First use in lazy mode, creates ep if needed too
+        if (!rmd->rkeyLoaded) {
+            ret = rkeyUnpack(rmd);
+            if (ret) {
+                xfer->release();
+                return ret;
+            }
+        }
+
+        // Following descriptors that continue this one in the remote region,
+        // and also locally if they can't be gathered
+        bool gather = iovGather;
+        for (last = i + 1; last < post_cnt; last++) {
+            if ((rdesc[last].metadataP != rdesc[i].metadataP) ||
+                (rdesc[last].addr != rdesc[last-1].addr + rdesc[last-1].len) ||
+                (ldesc[last].len != rdesc[last].len))
+                break;
+            if (!gather &&
+                ((ldesc[last].metadataP != ldesc[i].metadataP) ||
+                 (ldesc[last].addr != ldesc[last-1].addr + ldesc[last-1].len)))
+                break;
+        }
+
         // TODO: remote_agent and msg should be cached in nixlUCxReq or another way
 
-        switch (op) {
-        case NIXL_READ:
-        case NIXL_RD_NOTIF:
-            ret = uw->read(rmd->conn.ep, (uint64_t) raddr, rmd->rkey, laddr, lmd->mem, lsize, req);
-            break;
-        case NIXL_WRITE:
-        case NIXL_WR_NOTIF:
-            ret = uw->write(rmd->conn.ep, laddr, lmd->mem, (uint64_t) raddr, rmd->rkey, lsize, req);
-            break;
-        default:
-            return NIXL_ERR_INVALID_PARAM;
+        ret = NIXL_ERR_NOT_ALLOWED;
+        if (last - i > 1) {
+            if (gather && (xfer->iov.capacity() == 0))
+                xfer->iov.reserve(post_cnt);
+            ret = postGather(op, ldesc, rdesc, i, last, xfer);
+        }
+        if (ret == NIXL_ERR_NOT_ALLOWED) {
+            last = i + 1;
+            ret = postContig(op, ldesc[i], rdesc[i], xfer);
         }
+        if (ret) {
+            xfer->release();
+            return ret;
+        }
+    }
 
-        if (retHelper(ret, head, req)) {
+    // The fence orders the add behind the data ops on the same worker
+    if (signal) {
+        rmd = (nixlUcxPublicMetadata*) signal->metadataP;
+        ret = rmd->rkeyLoaded ? NIXL_SUCCESS : rkeyUnpack(rmd);
+        if (!ret)
+            ret = uw->fence();
+        if (!ret) {
+            xfer->hold();
+            ret = uw->atomicAdd(rmd->conn->ep, &xfer->signalAdd,
+                                (uint64_t) signal->addr, rmd->rkey, req,
+                                _opCompleteCb, xfer);
+            ret = retHelper(ret, xfer);
+        }
+        if (ret) {
+            xfer->release();
             return ret;
         }
     }
 
-    rmd = (nixlUcxPublicMetadata*) remote[0].metadataP;
-    ret = uw->flushEp(rmd->conn.ep, req);
-    if (retHelper(ret, head, req)) {
+    // Nothing to order the notification behind if it carries all the data
+    ret = NIXL_SUCCESS;
+    if (post_cnt == 0) {
+        // No ops posted
+    } else if (!lazyFlush || (op == NIXL_RD_NOTIF)) {
+        rmd = (nixlUcxPublicMetadata*) remote[0].metadataP;
+        xfer->hold();
+        ret = uw->flushEp(rmd->conn->ep, req, _opCompleteCb, xfer);
+        ret = retHelper(ret, xfer);
+    } else if (op == NIXL_WR_NOTIF) {
+        ret = uw->fence();
+    }
+    if (ret) {
+        xfer->release();
         return ret;
     }
 
-    switch (op) {
-        case NIXL_RD_NOTIF:
-        case NIXL_WR_NOTIF:
-            ret = notifSendPriv(remote_agent, notif_msg, req);
-            if (retHelper(ret, head, req)) {
-                return ret;
-            }
-            break;
-        case NIXL_WRITE:
-        case NIXL_READ:
-            break;
-        default:
-            return NIXL_ERR_INVALID_PARAM;
+    if ((op == NIXL_RD_NOTIF) || (op == NIXL_WR_NOTIF)) {
+        ret = notifSendPriv(remote_agent, notif_msg, xfer, inl_local, inl_remote);
+        if (ret) {
+            xfer->release();
+            return ret;
+        }
+    }
+
+    if (!xfer->inFlight()) {
+        ret = xfer->status;
+        xfer->release();
+        handle = NULL;
+        return ret;
     }
 
-    handle = head->next();
-    return (NULL ==  head->next()) ? NIXL_SUCCESS : NIXL_IN_PROG;
+    handle = xfer;
+    return NIXL_IN_PROG;
 }
 
 nixl_status_t nixlUcxEngine::checkXfer (nixlBackendReqH* handle)
 {
-    nixlUcxBckndReq *head = (nixlUcxBckndReq *)handle;
-    nixlUcxBckndReq *req = head;
-    nixl_status_t out_ret = NIXL_SUCCESS;
+    nixlUcxBckndReq *req = (nixlUcxBckndReq *)handle;
 
     /* If transfer has returned DONE - no check transfer */
-    if (NULL == head) {
+    if (NULL == req) {
         /* Nothing to do */
         return NIXL_ERR_INVALID_PARAM;
     }
 
-    /* Go over all request updating their status */
-    while(req) {
-        nixl_status_t ret;
-        if (!req->is_complete()) {
-            ret = uw->test((nixlUcxReq)req);
-            switch (ret) {
-                case NIXL_SUCCESS:
-                    /* Mark as completed */
-                    req->completed();
-                    break;
-                case NIXL_IN_PROG:
-                    out_ret = NIXL_IN_PROG;
-                    break;
-                default:
-                    /* Any other ret value is ERR and will be returned */
-                    return ret;
-            }
+    if (req->inFlight()) {
+        connProgress();
+        uw->progress();
+        if (req->inFlight() && (req->status == NIXL_SUCCESS)) {
+            return NIXL_IN_PROG;
         }
-        req = req->next();
     }
 
-    /* Remove completed requests keeping the first one as
-       request representative */
-    req = head->unlink();
-    while(req) {
-        nixlUcxBckndReq *next_req = req->unlink();
-        if (req->is_complete()) {
-            requestReset(req);
-            uw->reqRelease((nixlUcxReq)req);
-        } else {
-            /* Enqueue back */
-            head->link(req);
+    return req->status;
+}
+
+void nixlUcxEngine::releaseReqH(nixlBackendReqH* handle)
+{
+    // Ops still in flight keep the handle until they complete or fail
+    // with their endpoint, as UCX can't cancel RMA once posted
+    ((nixlUcxBckndReq *)handle)->release();
+}
+
+int nixlUcxEngine::progress() {
+    // TODO: add listen for connection handling if necessary
+    connProgress();
+    return uw->progress();
+}
+
+/****************************************
+ * Peer liveness
+*****************************************/
+
+// Called from progress until the ep is closed, which keeps conn alive
+void nixlUcxEngine::connErrCb(void *arg, ucp_ep_h ep, ucs_status_t status)
+{
+    nixlUcxConnection *conn = (nixlUcxConnection*) arg;
+
+    conn->engine->connFail(*conn);
+}
+
+// Holds a reference to the connection until the flush completes
+void nixlUcxEngine::keepaliveCb(void *request, ucs_status_t status, void *user_data)
+{
+    ucx_connection_ptr_t *conn = (ucx_connection_ptr_t*) user_data;
+
+    if (status == UCS_OK) {
+        (*conn)->kaSent = 0;
+    } else {
+        (*conn)->engine->connFail(**conn);
+    }
+    delete conn;
+    nixlUcxWorker::reqRelease(request);
+}
+
+void nixlUcxEngine::connFail(nixlUcxConnection &conn)
+{
+    // In this order, so connReap sees the connection once it sees the flag
+    conn.failed = true;
+    connFailed = true;
+}
+
+void nixlUcxEngine::connProgress()
+{
+    if (keepaliveUs) {
+        nixlTime::us_t now = nixlTime::getUs();
+        nixlTime::us_t next = kaNext.load(std::memory_order_relaxed);
+
+        // One thread per interval sends them
+        if ((now >= next) && kaNext.compare_exchange_strong(next, now + keepaliveUs))
+            connKeepalive(now);
+    }
+
+    connReap();
+}
+
+void nixlUcxEngine::connKeepalive(nixlTime::us_t now)
+{
+    static struct nixl_ucx_am_hdr hdr = {KEEPALIVE};
+    std::vector<ucx_connection_ptr_t> conns;
+    nixl_status_t ret;
+    nixlUcxReq req;
+
+    {
+        std::lock_guard<std::mutex> guard(connMtx);
+        for (auto & elm : remoteConnMap) {
+            if ((elm.first != localAgent) && (elm.second->state != UCX_CONN_RECORDED))
+                conns.push_back(elm.second);
+        }
+    }
+
+    for (auto & conn : conns) {
+        nixlUcxConnGuard conn_guard;
+
+        if (!conn_guard.enter(conn.get()))
+            continue;
+
+        // Still waiting for the previous one
+        nixlTime::us_t sent = conn->kaSent;
+        if (sent) {
+            if (now - sent > peerTimeoutUs)
+                connFail(*conn);
+            continue;
+        }
+
+        ret = uw->sendAm(conn->ep, KEEPALIVE, &hdr, sizeof(hdr), NULL, 0,
+                         UCP_AM_SEND_FLAG_EAGER, req);
+        if (ret == NIXL_IN_PROG) {
+            uw->reqRelease(req);
+        } else if (ret < 0) {
+            connFail(*conn);
+            continue;
         }
-        req = next_req;
+
+        // Set first, the callback can run on another thread right away
+        conn->kaSent = now;
+        ucx_connection_ptr_t *ref = new ucx_connection_ptr_t(conn);
+        ret = uw->flushEp(conn->ep, req, keepaliveCb, ref);
+        if (ret == NIXL_IN_PROG) // keepaliveCb frees req
+            continue;
+
+        delete ref;
+        conn->kaSent = 0;
+        if (ret < 0)
+            connFail(*conn);
     }
+}
 
-    return out_ret;
+// Waits for the threads posting on conn, failed has to be set
+void nixlUcxEngine::connDrain(nixlUcxConnection &conn)
+{
+    while (conn.posters.load())
+        std::this_thread::yield();
 }
 
-void nixlUcxEngine::releaseReqH(nixlBackendReqH* handle)
+void nixlUcxEngine::connReap()
 {
-    nixlUcxBckndReq *head = (nixlUcxBckndReq *)handle;
-    nixlUcxBckndReq *req = head;
-
-    //this case should not happen
-    //if (head == NULL) return;
-
-    if (head->next() || !head->is_complete()) {
-        // TODO: Error log: uncompleted requests found! Cancelling ...
-        while(head) {
-            bool done = req->is_complete();
-            req = head;
-            head = req->unlink();
-            requestReset(req);
-            if (!done) {
-                uw->reqCancel((nixlUcxReq)req);
+    std::vector<ucx_connection_ptr_t> dead;
+
+    if (!connFailed.load(std::memory_order_relaxed) || !connFailed.exchange(false))
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(connMtx);
+        for (auto & elm : remoteConnMap) {
+            if (elm.second->failed && !elm.second->closed) {
+                elm.second->closed = true;
+                dead.push_back(elm.second);
             }
-            uw->reqRelease((nixlUcxReq)req);
         }
-    } else {
-        /* All requests have been completed.
-           Only release the head request */
-        uw->reqRelease((nixlUcxReq)head);
+    }
+
+    for (auto & conn : dead) {
+        connDrain(*conn);
+
+        // Closing fails all ops still in flight on the ep, which completes
+        // their handles with an error. A CONN_CHECK in flight is failed
+        // too, and checkConnect moves the connection to UCX_CONN_FAILED.
+        std::lock_guard<std::mutex> guard(connMtx);
+        uw->disconnect_nb(conn->ep, true);
+        if (conn->state != UCX_CONN_CHECK_SENT)
+            conn->state = UCX_CONN_FAILED;
+        failedPeers.push_back(conn->remoteAgent);
+        failedReport = true;
     }
 }
 
-int nixlUcxEngine::progress() {
-    // TODO: add listen for connection handling if necessary
-    return uw->progress();
+void nixlUcxEngine::getFailedConns(std::vector<std::string> &remote_agents)
+{
+    connReap();
+    if (!failedReport.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> guard(connMtx);
+    remote_agents.insert(remote_agents.end(), failedPeers.begin(), failedPeers.end());
+    failedPeers.clear();
+    failedReport = false;
 }
 
 /****************************************
  * Notifications
 *****************************************/
 
+bool nixlUcxEngine::dramCovers(uintptr_t addr, size_t len)
+{
+    std::lock_guard<std::mutex> guard(dramMtx);
+
+    if ((len > UINTPTR_MAX - addr) || (len > dramMaxLen))
+        return false;
+
+    // Regions starting at or below addr, nearest first. Registrations can
+    // overlap, so a nearer one that ends too early doesn't decide it, but one
+    // starting more than the longest registration before the end can't cover
+    // it, nor can any below it.
+    auto it = dramRegions.upper_bound(addr);
+    while (it != dramRegions.begin()) {
+        it--;
+        if (addr + len - it->first > dramMaxLen)
+            break;
+        if (it->second >= addr + len)
+            return true;
+    }
+    return false;
+}
+
 //agent will provide cached msg
 nixl_status_t nixlUcxEngine::notifSendPriv(const std::string &remote_agent,
-                                           const std::string &msg, nixlUcxReq &req)
+                                           const std::string &msg, nixlUcxBckndReq *handle,
+                                           const nixlMetaDesc *inl_local,
+                                           const nixlMetaDesc *inl_remote)
 {
     nixlSerDes ser_des;
-    std::string *ser_msg;
-    nixlUcxConnection conn;
+    nixlUcxReq req;
     // TODO - temp fix, need to have an mpool
-    static struct nixl_ucx_am_hdr hdr;
+    static struct nixl_ucx_am_hdr str_hdr = {NOTIF_STR}, data_hdr = {NOTIF_DATA};
+    struct nixl_ucx_am_hdr *hdr = inl_local ? &data_hdr : &str_hdr;
     uint32_t flags = 0;
     nixl_status_t ret;
 
-    auto search = remoteConnMap.find(remote_agent);
+    ucx_connection_ptr_t conn_ptr = getConn(remote_agent);
 
-    if(search == remoteConnMap.end()) {
+    if(!conn_ptr) {
         //TODO: err: remote connection not found
         return NIXL_ERR_NOT_FOUND;
     }
 
-    conn = remoteConnMap[remote_agent];
+    nixlUcxConnection &conn = *conn_ptr;
+    nixlUcxConnGuard conn_guard;
+
+    if (!conn_guard.enter(&conn)) {
+        return NIXL_ERR_BACKEND;
+    }
+
+    // Notification can be the first use in lazy mode
+    {
+        std::lock_guard<std::mutex> guard(connMtx);
+        ret = connCreateEp(conn);
+    }
+    if (ret) {
+        return ret;
+    }
 
-    hdr.op = NOTIF_STR;
     flags |= UCP_AM_SEND_FLAG_EAGER;
 
     ser_des.addStr("name", localAgent);
     ser_des.addStr("msg", msg);
-    // TODO: replace with mpool for performance
-    ser_msg = new std::string(ser_des.exportStr());
-
-    ret = uw->sendAm(conn.ep, NOTIF_STR,
-                     &hdr, sizeof(struct nixl_ucx_am_hdr),
-                     (void*) ser_msg->data(), ser_msg->size(),
-                     flags, req);
-
-    if (ret == NIXL_IN_PROG) {
-        nixlUcxBckndReq* nReq = (nixlUcxBckndReq*)req;
-        nReq->amBuffer = ser_msg;
+    if (inl_local) {
+        uint64_t raddr = inl_remote->addr;
+        ser_des.addBuf("addr", &raddr, sizeof(raddr));
+        ser_des.addBuf("data", (void*) inl_local->addr, inl_local->len);
     }
-    return ret;
+    // The handle keeps the message until the send completes
+    handle->amBuffer = ser_des.exportStr();
+
+    handle->hold();
+    ret = uw->sendAm(conn.ep, hdr->op,
+                     hdr, sizeof(struct nixl_ucx_am_hdr),
+                     (void*) handle->amBuffer.data(), handle->amBuffer.size(),
+                     flags, req, _opCompleteCb, handle);
+    return retHelper(ret, handle);
 }
 
 ucs_status_t
@@ -899,11 +1544,11 @@ nixlUcxEngine::notifAmCb(void *arg, const void *header,
     struct nixl_ucx_am_hdr* hdr = (struct nixl_ucx_am_hdr*) header;
     nixlSerDes ser_des;
 
-    std::string ser_str( (char*) data, length);
     nixlUcxEngine* engine = (nixlUcxEngine*) arg;
-    std::string remote_name, msg;
+    const char *remote_name, *msg;
+    ssize_t name_len, msg_len;
 
-    if(hdr->op != NOTIF_STR) {
+    if((hdr->op != NOTIF_STR) && (hdr->op != NOTIF_DATA)) {
         //is this the best way to ERR?
         return UCS_ERR_INVALID_PARAM;
     }
@@ -914,39 +1559,70 @@ nixlUcxEngine::notifAmCb(void *arg, const void *header,
         return UCS_ERR_INVALID_PARAM;
     }
 
-    ser_des.importStr(ser_str);
-    remote_name = ser_des.getStr("name");
-    msg = ser_des.getStr("msg");
+    // Data is valid during the callback, no need to copy it
+    ser_des.importView(data, length);
+    if ((ser_des.getStrView("name", remote_name, name_len) != NIXL_SUCCESS) ||
+        (ser_des.getStrView("msg", msg, msg_len) != NIXL_SUCCESS)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    // Last chunk of a WR_NOTIF, must land in local DRAM registered with us.
+    // Like any notification it can come from an agent we haven't loaded.
+    if (hdr->op == NOTIF_DATA) {
+        uint64_t addr;
+        ssize_t len;
+
+        if ((ser_des.getBufLen("addr") != sizeof(addr)) ||
+            (ser_des.getBuf("addr", &addr, sizeof(addr)) != NIXL_SUCCESS)) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+        len = ser_des.getBufLen("data");
+        if ((len < 0) || !engine->dramCovers(addr, len) ||
+            (ser_des.getBuf("data", (void*) addr, len) != NIXL_SUCCESS)) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+    }
 
     if (engine->isProgressThread()) {
         /* Append to the private list to allow batching */
-        engine->notifPthrPriv.push_back(std::make_pair(remote_name, msg));
+        engine->notifPthrPriv.add(remote_name, name_len, msg, msg_len);
     } else {
-        engine->notifMainList.push_back(std::make_pair(remote_name, msg));
+        /* Any number of app threads can progress the worker at once */
+        std::lock_guard<std::mutex> lock(engine->notifMtx);
+        if (engine->notifCbOn) {
+            /* Hand over to the progress thread for the callback */
+            engine->notifPthr.add(remote_name, name_len, msg, msg_len);
+        } else {
+            engine->notifMainList.add(remote_name, name_len, msg, msg_len);
+        }
     }
 
     return UCS_OK;
 }
 
 
-void nixlUcxEngine::notifCombineHelper(notif_list_t &src, notif_list_t &tgt)
+void nixlUcxEngine::notifCombineHelper(nixlNotifArena &src, nixlNotifArena &tgt)
 {
     if (!src.size()) {
         // Nothing to do. Exit
         return;
     }
 
-    move(src.begin(), src.end(), back_inserter(tgt));
-    src.erase(src.begin(), src.end());
+    tgt.append(src);
+    src.clear();
 }
 
-void nixlUcxEngine::notifProgressCombineHelper(notif_list_t &src, notif_list_t &tgt)
+void nixlUcxEngine::notifProgressCombineHelper(nixlNotifArena &src, nixlNotifArena &tgt)
 {
     notifMtx.lock();
 
-    if (src.size()) {
-        move(src.begin(), src.end(), back_inserter(tgt));
-        src.erase(src.begin(), src.end());
+    if (!tgt.size()) {
+        // Internal arenas, so agent ids can move with the records
+        std::swap(src, tgt);
+        src.clear();
+    } else if (src.size()) {
+        tgt.append(src);
+        src.clear();
     }
 
     notifMtx.unlock();
@@ -954,38 +1630,82 @@ void nixlUcxEngine::notifProgressCombineHelper(notif_list_t &src, notif_list_t &
 
 void nixlUcxEngine::notifProgress()
 {
-    notifProgressCombineHelper(notifPthrPriv, notifPthr);
+    if (!notifCbOn) {
+        notifProgressCombineHelper(notifPthrPriv, notifPthr);
+        return;
+    }
+
+    std::lock_guard<std::mutex> cb_lock(notifCbMtx);
+    notifMtx.lock();
+    nixl_notif_cb_t cb = notifCb;
+    void* cb_arg = notifCbArg;
+    // Take what other threads received, keeping the arrival order
+    if (cb && notifPthr.size()) {
+        notifPthr.append(notifPthrPriv);
+        std::swap(notifPthr, notifPthrPriv);
+        notifPthr.clear();
+    }
+    notifMtx.unlock();
+
+    if (!cb) {
+        notifProgressCombineHelper(notifPthrPriv, notifPthr);
+    } else if (notifPthrPriv.size()) {
+        cb(notifPthrPriv, cb_arg);
+        notifPthrPriv.clear();
+    }
+}
+
+int nixlUcxEngine::drainNotifs(nixlNotifArena &arena)
+{
+    size_t count = arena.size();
+
+    if(!pthrOn) while(progress());
+
+    notifMtx.lock();
+    notifCombineHelper(notifMainList, arena);
+    notifCombineHelper(notifPthr, arena);
+    notifMtx.unlock();
+
+    return (int) (arena.size() - count);
 }
 
 int nixlUcxEngine::getNotifs(notif_list_t &notif_list)
 {
+    nixlNotifArena arena;
+
     if (notif_list.size()!=0)
         return -1;
 
-    if(!pthrOn) while(progress());
-
-    notifCombineHelper(notifMainList, notif_list);
-    notifProgressCombineHelper(notifPthr, notif_list);
+    drainNotifs(arena);
+    for (auto & rec : arena.recs)
+        notif_list.push_back(std::make_pair(arena.agents[rec.agentId],
+                                            std::string(arena.msg(rec), rec.len)));
 
     return notif_list.size();
 }
 
+nixl_status_t nixlUcxEngine::setNotifCallback(nixl_notif_cb_t cb, void* arg)
+{
+    // Needs the progress thread to deliver them
+    if (!pthrOn)
+        return NIXL_ERR_NOT_ALLOWED;
+
+    std::lock_guard<std::mutex> cb_lock(notifCbMtx);
+    std::lock_guard<std::mutex> lock(notifMtx);
+    notifCb = cb;
+    notifCbArg = arg;
+    notifCbOn = (cb != NULL);
+    return NIXL_SUCCESS;
+}
+
 nixl_status_t nixlUcxEngine::genNotif(const std::string &remote_agent, const std::string &msg)
 {
+    nixlUcxBckndReq *req = new nixlUcxBckndReq;
     nixl_status_t ret;
-    nixlUcxReq req;
 
     ret = notifSendPriv(remote_agent, msg, req);
 
-    switch(ret) {
-    case NIXL_IN_PROG:
-        /* do not track the request */
-        uw->reqRelease(req);
-    case NIXL_SUCCESS:
-        break;
-    default:
-        /* error case */
-        return ret;
-    }
-    return NIXL_SUCCESS;
+    /* do not track the request, its send frees it */
+    req->release();
+    return ret;
 }
@@ -18,10 +18,13 @@
 #define __UCX_BACKEND_H
 
 #include <vector>
+#include <map>
 #include <cstring>
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <memory>
+#include <atomic>
 
 #include "nixl.h"
 #include "backend/backend_engine.h"
@@ -30,7 +33,6 @@
 // Local includes
 #include <nixl_time.h>
 #include <ucx_utils.h>
-#include <list_elem.h>
 
 #ifdef HAVE_CUDA
 
@@ -39,32 +41,102 @@
 
 #endif
 
-typedef enum {CONN_CHECK, NOTIF_STR, DISCONNECT} ucx_cb_op_t;
+typedef enum {CONN_CHECK, NOTIF_STR, DISCONNECT, NOTIF_DATA, KEEPALIVE} ucx_cb_op_t;
+
+// Largest notification AM carrying data, below the size UCX switches to
+// rendezvous at on its common transports. The overhead covers the serdes
+// header, tags and lengths around the name, message, address and data.
+#define NOTIF_EAGER_MAX   8192
+#define NOTIF_AM_OVERHEAD 128
+
+// Connection setup: ep is created when conn info is loaded, or on first use
+// in lazy mode. Then connect sends a CONN_CHECK AM, which can complete later
+// through progress.
+// A connection fails from any state with an ep, when UCX reports an ep
+// error or a keepalive isn't acknowledged in time. The next progress call
+// closes the ep, which fails the ops in flight on it, and the agent is told
+// through getFailedConns.
+typedef enum {
+    UCX_CONN_RECORDED, // Lazy mode, only conn info is kept, no ep yet
+    UCX_CONN_LOADED,
+    UCX_CONN_CHECK_SENT,
+    UCX_CONN_ESTABLISHED,
+    UCX_CONN_FAILED
+} ucx_conn_state_t;
 
 struct nixl_ucx_am_hdr {
     ucx_cb_op_t op;
 };
 
+class nixlUcxEngine;
+
 class nixlUcxConnection : public nixlBackendConnMD {
     private:
         std::string remoteAgent;
+        std::string connInfo; // Worker address, kept until the ep is created
         nixlUcxEp ep;
-        volatile bool connected;
+        ucx_conn_state_t state;
+        nixlUcxReq checkReq; // CONN_CHECK AM while in UCX_CONN_CHECK_SENT
+        nixlUcxEngine *engine;
+
+        // No new ops are posted once failed is set. Threads posting count
+        // themselves in posters, and the ep is closed after they are done.
+        std::atomic<bool> failed;
+        std::atomic<size_t> posters;
+        bool closed; // Under connMtx, ep closed or about to be
+        // Start of the outstanding keepalive, 0 if none
+        std::atomic<nixlTime::us_t> kaSent;
 
     public:
-        // Extra information required for UCX connections
+        nixlUcxConnection() : state(UCX_CONN_RECORDED), checkReq(nullptr),
+                              engine(nullptr), failed(false), posters(0),
+                              closed(false), kaSent(0) {}
 
     friend class nixlUcxEngine;
+    friend class nixlUcxConnGuard;
+};
+
+// Keeps the ep of a connection open while ops are posted on it
+class nixlUcxConnGuard {
+    private:
+        nixlUcxConnection *conn;
+
+    public:
+        nixlUcxConnGuard() : conn(nullptr) {}
+        ~nixlUcxConnGuard() {
+            if (conn)
+                conn->posters.fetch_sub(1);
+        }
+
+        // False if the connection failed, then nothing may be posted on it
+        bool enter(nixlUcxConnection *c) {
+            c->posters.fetch_add(1);
+            if (c->failed.load()) {
+                c->posters.fetch_sub(1);
+                return false;
+            }
+            conn = c;
+            return true;
+        }
 };
 
+// Shared by the engine and the metadata of the remote agent, so an ep
+// created later is seen by all of them
+typedef std::shared_ptr<nixlUcxConnection> ucx_connection_ptr_t;
+
 // A private metadata has to implement get, and has all the metadata
 class nixlUcxPrivateMetadata : public nixlBackendMD {
     private:
         nixlUcxMem mem;
         std::string rkeyStr;
+        // DRAM registrations can be written by NOTIF_DATA
+        uintptr_t dramAddr;
+        size_t dramLen;
 
     public:
         nixlUcxPrivateMetadata() : nixlBackendMD(true) {
+            dramAddr = 0;
+            dramLen  = 0;
         }
 
         ~nixlUcxPrivateMetadata(){
@@ -82,9 +154,13 @@ class nixlUcxPublicMetadata : public nixlBackendMD {
 
     public:
         nixlUcxRkey rkey;
-        nixlUcxConnection conn;
+        ucx_connection_ptr_t conn;
+        // In lazy mode the packed rkey is kept, and unpacked on first use
+        std::string rkeyStr;
+        // Set once under connMtx, checked without it on the transfer path
+        std::atomic<bool> rkeyLoaded;
 
-        nixlUcxPublicMetadata() : nixlBackendMD(false) {}
+        nixlUcxPublicMetadata() : nixlBackendMD(false) { rkeyLoaded = false; }
 
         ~nixlUcxPublicMetadata(){
         }
@@ -111,40 +187,113 @@ class nixlUcxEngine : public nixlBackendEngine {
         int noSyncIters;
         std::thread pthr;
         nixlTime::us_t pthrDelay;
+        // The agent's thread progresses the engine instead of pthr
+        bool pthrAgent;
+        // Thread that progresses the engine, set when it starts or attaches
+        std::atomic<std::thread::id> pthrId;
+        // CUDA context changed, the agent's thread applies it next round
+        std::atomic<bool> pthrCtxStale;
+        // Worker event fd if the agent's thread waits on it, -1 otherwise
+        int pthrEfd;
 
         /* CUDA data*/
         nixlUcxCudaCtx *cudaCtx;
         bool cuda_addr_wa;
 
-        /* Notifications */
-        notif_list_t notifMainList;
+        /* Notifications, packed so receiving them doesn't allocate.
+           notifMtx guards notifMainList and notifPthr, which other threads
+           add to, notifPthrPriv is only used by the progress thread. */
+        nixlNotifArena notifMainList;
         std::mutex  notifMtx;
-        notif_list_t notifPthrPriv, notifPthr;
+        nixlNotifArena notifPthrPriv, notifPthr;
+        // Batch callback, set under notifCbMtx and notifMtx. The progress
+        // thread holds notifCbMtx while calling it.
+        nixl_notif_cb_t notifCb;
+        void* notifCbArg;
+        std::atomic<bool> notifCbOn;
+        std::mutex notifCbMtx;
 
         // Map of agent name to saved nixlUcxConnection info
-        std::unordered_map<std::string, nixlUcxConnection,
+        std::unordered_map<std::string, ucx_connection_ptr_t,
                            std::hash<std::string>, strEqual> remoteConnMap;
-
-		class nixlUcxBckndReq : public nixlLinkElem<nixlUcxBckndReq>, public nixlBackendReqH {
+        // Guards remoteConnMap and the lazy ep and rkey setup, as metadata
+        // can be loaded by transfer threads while connections are changed
+        std::mutex connMtx;
+
+        // Create eps and unpack rkeys on first use instead of at load time
+        bool lazyConnect;
+
+        // Peer liveness: a failed connection sets connFailed, and the next
+        // progress call closes its ep and queues the agent in failedPeers
+        // (under connMtx) for getFailedConns.
+        std::atomic<bool> connFailed;
+        std::atomic<bool> failedReport;
+        std::vector<std::string> failedPeers;
+        // With keepalive_ms, every connection with an ep gets a KEEPALIVE AM
+        // and a flush behind it that often. The peer is failed if the flush
+        // isn't done after peer_timeout_ms (default 10 intervals).
+        // 0 = no keepalives.
+        nixlTime::us_t keepaliveUs;
+        nixlTime::us_t peerTimeoutUs;
+        std::atomic<nixlTime::us_t> kaNext;
+
+        // Experimental, off unless iov_gather is "true": post local
+        // fragments of one remote-contiguous region as a single iov op. UCX
+        // RMA doesn't take the iov datatype on most transports, so it's
+        // cleared the first time one is refused. Without it, fragments that
+        // are contiguous on both sides are still merged into one op.
+        std::atomic<bool> iovGather;
+
+        // Completion of a transfer with flush_mode "always" (default): every
+        // transfer ends with an endpoint flush, so at completion all data is
+        // visible at the target, and a notification is sent behind it.
+        // With "lazy" the flush round trip is left out where possible:
+        //  - READ completes when the gets have landed in local memory.
+        //  - WRITE completes when the source buffers can be reused. The data
+        //    is visible at the target only after a later flushed transfer or
+        //    notification to it.
+        //  - WR_NOTIF puts a worker fence between the puts and the
+        //    notification, so the target sees the data before the
+        //    notification on transports that deliver in order.
+        //  - RD_NOTIF still flushes, the target may not reuse its buffers
+        //    until the gets have read them.
+        bool lazyFlush;
+
+        // WR_NOTIF carries its last descriptor inside the notification if it
+        // is DRAM on both sides and at most notif_inline bytes (0 = off).
+        // The target copies it in before queueing the notification, so the
+        // data is visible when the notification is seen; the initiator
+        // completes once the AM is sent. The whole AM has to stay within
+        // NOTIF_EAGER_MAX, or the target would get it as rendezvous and drop
+        // it, so larger ones are written with the other descriptors.
+        size_t notifInline;
+        // Start and end of local DRAM registrations, to check NOTIF_DATA,
+        // and the longest one so far, which bounds the regions checked
+        std::multimap<uintptr_t, uintptr_t> dramRegions;
+        size_t dramMaxLen;
+        std::mutex dramMtx;
+
+        // Handle of a posted transfer. The owner holds one reference until
+        // releaseReqH, and each op in flight holds one that its completion
+        // callback drops, so checking for completion only reads a counter.
+        class nixlUcxBckndReq : public nixlBackendReqH {
             private:
-                int _completed;
+                std::atomic<size_t> refs;
             public:
-                std::string *amBuffer;
-
-                nixlUcxBckndReq() : nixlLinkElem(), nixlBackendReqH() {
-                    _completed = 0;
-                    amBuffer = NULL;
-                }
-
-                ~nixlUcxBckndReq() {
-                    _completed = 0;
-                    if (amBuffer) {
-                        delete amBuffer;
-                    }
+                std::atomic<nixl_status_t> status; // First failure of an op
+                std::vector<ucp_dt_iov_t> iov; // Gather lists, reserved upfront
+                std::string amBuffer;          // Notification, if any
+                uint64_t signalAdd;            // Operand of the signal add
+
+                nixlUcxBckndReq() : nixlBackendReqH(), refs(1),
+                                    status(NIXL_SUCCESS), signalAdd(1) {}
+
+                bool inFlight() const { return refs.load(std::memory_order_acquire) > 1; }
+                void hold() { refs.fetch_add(1, std::memory_order_relaxed); }
+                void release() {
+                    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        delete this;
                 }
-
-                bool is_complete() { return _completed; }
-                void completed() { _completed = 1; }
         };
 
         void vramInitCtx();
@@ -152,22 +301,17 @@ class nixlUcxEngine : public nixlBackendEngine {
         int vramUpdateCtx(void *address, uint32_t  devId, bool &restart_reqd);
         int vramApplyCtx();
 
-        // Threading infrastructure
-        //   TODO: move the thread management one outside of NIXL common infra
+        // Threading infrastructure, unless the agent runs the thread
         void progressFunc();
         void progressThreadStart();
         void progressThreadStop();
         void progressThreadRestart();
         bool isProgressThread(){
-            return (std::this_thread::get_id() == pthr.get_id());
+            return (std::this_thread::get_id() == pthrId.load());
         }
 
         // Request management
-        static void _requestInit(void *request);
-        static void _requestFini(void *request);
-        void requestReset(nixlUcxBckndReq *req) {
-            _requestInit((void *)req);
-        }
+        static void _opCompleteCb(void *request, ucs_status_t status, void *user_data);
 
         // Connection helper
         static ucs_status_t
@@ -182,20 +326,55 @@ class nixlUcxEngine : public nixlBackendEngine {
                            size_t length,
                            const ucp_am_recv_param_t *param);
 
+        static ucs_status_t
+        keepaliveAmCb(void *arg, const void *header,
+                      size_t header_length, void *data,
+                      size_t length,
+                      const ucp_am_recv_param_t *param);
+
+        // Peer liveness, called from progress
+        static void connErrCb(void *arg, ucp_ep_h ep, ucs_status_t status);
+        static void keepaliveCb(void *request, ucs_status_t status, void *user_data);
+        void connFail(nixlUcxConnection &conn);
+        void connProgress();
+        void connKeepalive(nixlTime::us_t now);
+        void connReap();
+        void connDrain(nixlUcxConnection &conn);
+
         // Notifications
         static ucs_status_t notifAmCb(void *arg, const void *header,
                                       size_t header_length, void *data,
                                       size_t length,
                                       const ucp_am_recv_param_t *param);
         nixl_status_t notifSendPriv(const std::string &remote_agent,
-                                    const std::string &msg, nixlUcxReq &req);
+                                    const std::string &msg, nixlUcxBckndReq *req,
+                                    const nixlMetaDesc *inl_local = NULL,
+                                    const nixlMetaDesc *inl_remote = NULL);
+        bool dramCovers(uintptr_t addr, size_t len);
         void notifProgress();
-        void notifCombineHelper(notif_list_t &src, notif_list_t &tgt);
-        void notifProgressCombineHelper(notif_list_t &src, notif_list_t &tgt);
+        void notifCombineHelper(nixlNotifArena &src, nixlNotifArena &tgt);
+        void notifProgressCombineHelper(nixlNotifArena &src, nixlNotifArena &tgt);
+
 
+        // Lazy connection helpers, no-op if already done
+        ucx_connection_ptr_t getConn(const std::string &remote_agent);
+        nixl_status_t connCreateEp(nixlUcxConnection &conn); // connMtx held
+        nixl_status_t rkeyUnpack(nixlUcxPublicMetadata* md);
 
         // Data transfer (priv)
-        nixl_status_t retHelper(nixl_status_t ret, nixlUcxBckndReq *head, nixlUcxReq &req);
+        nixl_status_t retHelper(nixl_status_t ret, nixlUcxBckndReq *handle);
+        nixl_status_t postContig(const nixl_xfer_op_t &op, const nixlMetaDesc &ldesc,
+                                 const nixlMetaDesc &rdesc, nixlUcxBckndReq *handle);
+        nixl_status_t postGather(const nixl_xfer_op_t &op, const nixlMetaDesc *ldesc,
+                                 const nixlMetaDesc *rdesc, size_t first, size_t last,
+                                 nixlUcxBckndReq *handle);
+        nixl_status_t postXferPriv(const nixl_meta_dlist_t &local,
+                                   const nixl_meta_dlist_t &remote,
+                                   const nixl_xfer_op_t &op,
+                                   const std::string &remote_agent,
+                                   const std::string &notif_msg,
+                                   const nixlMetaDesc *signal,
+                                   nixlBackendReqH* &handle);
 
     public:
         nixlUcxEngine(const nixlBackendInitParams* init_params);
@@ -205,6 +384,7 @@ class nixlUcxEngine : public nixlBackendEngine {
         bool supportsLocal () const { return true; }
         bool supportsNotif () const { return true; }
         bool supportsProgTh () const { return pthrOn; }
+        bool supportsSignal () const { return true; }
 
         /* Object management */
         std::string getPublicData (const nixlBackendMD* meta) const;
@@ -214,6 +394,9 @@ class nixlUcxEngine : public nixlBackendEngine {
 
         nixl_status_t connect(const std::string &remote_agent);
         nixl_status_t disconnect(const std::string &remote_agent);
+        nixl_status_t connectAsync(const std::string &remote_agent);
+        nixl_status_t checkConnect(const std::string &remote_agent);
+        void getFailedConns(std::vector<std::string> &remote_agents);
 
         nixl_status_t registerMem (const nixlStringDesc &mem,
                                    const nixl_mem_t &nixl_mem,
@@ -236,12 +419,25 @@ class nixlUcxEngine : public nixlBackendEngine {
                                 const std::string &remote_agent,
                                 const std::string &notif_msg,
                                 nixlBackendReqH* &handle);
+        nixl_status_t postXferSignal (const nixl_meta_dlist_t &local,
+                                      const nixl_meta_dlist_t &remote,
+                                      const nixl_xfer_op_t &op,
+                                      const std::string &remote_agent,
+                                      const std::string &notif_msg,
+                                      const nixlMetaDesc &signal,
+                                      nixlBackendReqH* &handle);
         nixl_status_t checkXfer (nixlBackendReqH* handle);
         void releaseReqH(nixlBackendReqH* handle);
 
         int progress();
+        void pthrAttach();
+        int pthrRound();
+        int pthrFd() { return pthrEfd; }
+        bool pthrArm();
 
         int getNotifs(notif_list_t &notif_list);
+        int drainNotifs(nixlNotifArena &arena);
+        nixl_status_t setNotifCallback(nixl_notif_cb_t cb, void* arg);
         nixl_status_t genNotif(const std::string &remote_agent, const std::string &msg);
 
         //public function for UCX worker to mark connections as connected
@@ -57,6 +57,7 @@ PYBIND11_MODULE(_bindings, m) {
         .value("NIXL_ERR_NOT_ALLOWED", NIXL_ERR_NOT_ALLOWED)
         .value("NIXL_ERR_REPOST_ACTIVE", NIXL_ERR_REPOST_ACTIVE)
         .value("NIXL_ERR_UNKNOWN", NIXL_ERR_UNKNOWN)
+        .value("NIXL_ERR_TIMEOUT", NIXL_ERR_TIMEOUT)
         .export_values();
 
     py::class_<nixl_xfer_dlist_t>(m, "nixlXferDList")
@@ -185,6 +186,8 @@ PYBIND11_MODULE(_bindings, m) {
                     return agent.deregisterMem(descs, (nixlBackendH*) backend);
                 })
         .def("makeConnection", &nixlAgent::makeConnection)
+        .def("makeConnectionAsync", &nixlAgent::makeConnectionAsync)
+        .def("checkConnection", &nixlAgent::checkConnection)
         //note: slight API change, python cannot receive values by passing refs, so handle must be returned
         .def("createXferReq", [](nixlAgent &agent,
                                  const nixl_xfer_dlist_t &local_descs,
@@ -233,8 +236,16 @@ PYBIND11_MODULE(_bindings, m) {
         .def("invalidateXferSide", [](nixlAgent &agent, uintptr_t handle) -> void {
                     agent.invalidateXferSide((nixlXferSideH*) handle);
                 })
-        .def("postXferReq", [](nixlAgent &agent, uintptr_t reqh) -> nixl_status_t {
-                    return agent.postXferReq((nixlXferReqH*) reqh);
+        .def("setXferSignal", [](nixlAgent &agent, uintptr_t reqh, uintptr_t addr,
+                                 uint32_t dev_id) -> nixl_status_t {
+                    return agent.setXferSignal((nixlXferReqH*) reqh,
+                                               nixlBasicDesc(addr, sizeof(uint64_t), dev_id));
+                })
+        .def("postXferReq", [](nixlAgent &agent, uintptr_t reqh, uint64_t timeout_us) -> nixl_status_t {
+                    return agent.postXferReq((nixlXferReqH*) reqh, timeout_us);
+                }, py::arg("reqh"), py::arg("timeout_us")=0)
+        .def("cancelXferReq", [](nixlAgent &agent, uintptr_t reqh) -> nixl_status_t {
+                    return agent.cancelXferReq((nixlXferReqH*) reqh);
                 })
         .def("getXferStatus", [](nixlAgent &agent, uintptr_t reqh) -> nixl_status_t {
                     return agent.getXferStatus((nixlXferReqH*) reqh);
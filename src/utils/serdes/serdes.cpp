@@ -16,11 +16,26 @@
  */
 #include "serdes.h"
 
-nixlSerDes::nixlSerDes() {
-    workingStr = "nixlSerDes|";
-    des_offset = 11;
+#define SERDES_HDR       "nixlSerDes|"
+#define SERDES_HDR_LEN   11
+// Rejected by readers without compression support, as the prefix differs
+#define SERDES_C_HDR     "nixlSerDesC|"
+#define SERDES_C_HDR_LEN 12
+
+nixlSerDes::nixlSerDes(const bool &compress_descs) {
+    compressDescs = compress_descs;
+    workingStr = compress_descs ? SERDES_C_HDR : SERDES_HDR;
+    des_offset = compress_descs ? SERDES_C_HDR_LEN : SERDES_HDR_LEN;
 
     mode = SERIALIZE;
+    readBuf = nullptr;
+    readLen = 0;
+}
+
+bool nixlSerDes::checkTag(ssize_t offset, const std::string &tag) const {
+    if(offset + tag.size() > readSize())
+        return false;
+    return (memcmp(readData() + offset, tag.data(), tag.size()) == 0);
 }
 
 std::string nixlSerDes::_bytesToString(const void *buf, ssize_t size) {
@@ -32,6 +47,26 @@ void nixlSerDes::_stringToBytes(void* fill_buf, const std::string &s, ssize_t si
     s.copy(reinterpret_cast<char*>(fill_buf), size); 
 }
 
+//LEB128, 7 bits per byte with the top bit set if more bytes follow
+void nixlSerDes::_appendVarint(std::string &s, uint64_t val){
+    while(val >= 0x80){
+        s.push_back((char) ((val & 0x7f) | 0x80));
+        val >>= 7;
+    }
+    s.push_back((char) val);
+}
+
+bool nixlSerDes::_readVarint(const char* &ptr, const char* end, uint64_t &val){
+    val = 0;
+    for(int shift = 0; shift < 64 && ptr < end; shift += 7){
+        uint8_t byte = (uint8_t) *ptr++;
+        val |= (uint64_t) (byte & 0x7f) << shift;
+        if((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
 /* Ser/Des for Strings */
 nixl_status_t nixlSerDes::addStr(const std::string &tag, const std::string &str){
 
@@ -46,28 +81,40 @@ nixl_status_t nixlSerDes::addStr(const std::string &tag, const std::string &str)
 }
 
 std::string nixlSerDes::getStr(const std::string &tag){
+    const char* str;
+    ssize_t len;
 
-    if(workingStr.compare(des_offset, tag.size(), tag) != 0){
+    if(getStrView(tag, str, len) != NIXL_SUCCESS)
+        return "";
+
+    return std::string(str, len);
+}
+
+nixl_status_t nixlSerDes::getStrView(const std::string &tag, const char* &str, ssize_t &len){
+
+    if(!checkTag(des_offset, tag)){
        //incorrect tag
-       return "";
-    } 
-    ssize_t len;
+       return NIXL_ERR_MISMATCH;
+    }
 
     //skip tag
-    des_offset += tag.size();
-    
+    size_t offset = des_offset + tag.size();
+
     //get len
-    //_stringToBytes(&len, workingStr.data() + des_offset, sizeof(ssize_t));
-    _stringToBytes(&len, workingStr.substr(des_offset, sizeof(ssize_t)), sizeof(ssize_t));
-    des_offset += sizeof(ssize_t);
+    if(offset + sizeof(ssize_t) > readSize())
+        return NIXL_ERR_MISMATCH;
+    memcpy(&len, readData() + offset, sizeof(ssize_t));
+    offset += sizeof(ssize_t);
+
+    //string plus | delimiter has to fit
+    if(len < 0 || offset + len + 1 > readSize())
+        return NIXL_ERR_MISMATCH;
+    str = readData() + offset;
 
-    //get string
-    std::string ret = workingStr.substr(des_offset, len);
-    
     //move past string plus | delimiter
-    des_offset += len + 1;
+    des_offset = offset + len + 1;
 
-    return ret;
+    return NIXL_SUCCESS;
 }
 
 /* Ser/Des for Byte buffers */
@@ -82,34 +129,38 @@ nixl_status_t nixlSerDes::addBuf(const std::string &tag, const void* buf, ssize_
 }
 
 ssize_t nixlSerDes::getBufLen(const std::string &tag) const{
-    if(workingStr.compare(des_offset, tag.size(), tag) != 0){
+    if(!checkTag(des_offset, tag)){
        //incorrect tag
        return -1;
-    } 
+    }
 
     ssize_t len;
+    size_t offset = des_offset + tag.size();
 
     //get len
-    //_stringToBytes(&len, workingStr.data() + des_offset + tag.size(), sizeof(ssize_t));
-    _stringToBytes(&len, workingStr.substr(des_offset + tag.size(), sizeof(ssize_t)), sizeof(ssize_t));
+    if(offset + sizeof(ssize_t) > readSize())
+        return -1;
+    memcpy(&len, readData() + offset, sizeof(ssize_t));
 
     return len;
 }
 
 nixl_status_t nixlSerDes::getBuf(const std::string &tag, void *buf, ssize_t len){
-    if(workingStr.compare(des_offset, tag.size(), tag) != 0){
+    if(!checkTag(des_offset, tag)){
        //incorrect tag
        return NIXL_ERR_MISMATCH;
     }
-    
+
     //skip over tag and size, which we assume has been read previously
-    des_offset += tag.size() + sizeof(ssize_t);
+    size_t offset = des_offset + tag.size() + sizeof(ssize_t);
 
-    //_stringToBytes(buf, workingStr.data() + des_offset, len);
-    _stringToBytes(buf, workingStr.substr(des_offset, len), len);
+    //buffer plus | delimiter has to fit
+    if(len < 0 || offset + len + 1 > readSize())
+        return NIXL_ERR_MISMATCH;
+    memcpy(buf, readData() + offset, len);
 
-    //bytes in string form are twice as long, skip those plus | delimiter
-    des_offset += len + 1;
+    //skip those plus | delimiter
+    des_offset = offset + len + 1;
 
     return NIXL_SUCCESS;
 }
@@ -120,16 +171,53 @@ std::string nixlSerDes::exportStr() const {
     return ret_str;
 }
 
+//returns header length, or 0 if it's not a valid header
+static ssize_t checkHeader(const void* buf, size_t len, bool &compress_descs) {
+    if(len >= SERDES_HDR_LEN && memcmp(buf, SERDES_HDR, SERDES_HDR_LEN) == 0){
+        compress_descs = false;
+        return SERDES_HDR_LEN;
+    }
+    if(len >= SERDES_C_HDR_LEN && memcmp(buf, SERDES_C_HDR, SERDES_C_HDR_LEN) == 0){
+        compress_descs = true;
+        return SERDES_C_HDR_LEN;
+    }
+    return 0;
+}
+
 nixl_status_t nixlSerDes::importStr(const std::string &sdbuf) {
- 
-    if(sdbuf.compare(0, 11, "nixlSerDes|") != 0){
+    bool compress;
+    ssize_t hdr_len = checkHeader(sdbuf.data(), sdbuf.size(), compress);
+
+    if(hdr_len == 0){
        //incorrect tag
        return NIXL_ERR_MISMATCH;
-    }    
+    }
 
     workingStr = sdbuf;
     mode = DESERIALIZE;
-    des_offset = 11;
+    des_offset = hdr_len;
+    compressDescs = compress;
+    readBuf = nullptr;
+    readLen = 0;
+
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t nixlSerDes::importView(const void* buf, size_t len) {
+    bool compress;
+    ssize_t hdr_len = checkHeader(buf, len, compress);
+
+    if(hdr_len == 0){
+       //incorrect tag
+       return NIXL_ERR_MISMATCH;
+    }
+
+    workingStr.clear();
+    mode = DESERIALIZE;
+    des_offset = hdr_len;
+    compressDescs = compress;
+    readBuf = reinterpret_cast<const char*>(buf);
+    readLen = len;
 
     return NIXL_SUCCESS;
 }
@@ -30,13 +30,31 @@ private:
     std::string workingStr;
     ssize_t des_offset;
     ser_mode_t mode;
+    bool compressDescs;
+
+    // caller's buffer from importView, deserialize workingStr if null
+    const char* readBuf;
+    size_t readLen;
+
+    inline const char* readData() const
+        { return readBuf ? readBuf : workingStr.data(); }
+    inline size_t readSize() const
+        { return readBuf ? readLen : workingStr.size(); }
+    bool checkTag(ssize_t offset, const std::string &tag) const;
 
 public:
-    nixlSerDes();
+    // With compress_descs, descriptor lists use a compact encoding. It's
+    // marked in the blob header, so readers pick it up on import.
+    nixlSerDes(const bool &compress_descs=false);
+    // Not copyable, readBuf is a view of the caller's buffer
+    nixlSerDes(const nixlSerDes &sd) = delete;
+    nixlSerDes& operator=(const nixlSerDes &sd) = delete;
 
     /* Ser/Des for Strings */
     nixl_status_t addStr(const std::string &tag, const std::string &str);
     std::string getStr(const std::string &tag);
+    // pointer into the deserialized buffer instead of a copy
+    nixl_status_t getStrView(const std::string &tag, const char* &str, ssize_t &len);
 
     /* Ser/Des for Byte buffers */
     nixl_status_t addBuf(const std::string &tag, const void* buf, ssize_t len);
@@ -46,8 +64,17 @@ public:
     /* Ser/Des buffer management */
     std::string exportStr() const;
     nixl_status_t importStr(const std::string &sdbuf);
+    // deserialize from caller's memory without copying, e.g., an mmap'ed
+    // file. buf has to stay valid as long as this object is used.
+    nixl_status_t importView(const void* buf, size_t len);
+
+    inline bool descCompression() const { return compressDescs; }
+    // Bytes left to deserialize, to bound counts read from the buffer
+    inline size_t remainingLen() const { return readSize() - des_offset; }
 
     static std::string _bytesToString(const void *buf, ssize_t size);
+    static void _appendVarint(std::string &s, uint64_t val);
+    static bool _readVarint(const char* &ptr, const char* end, uint64_t &val);
     static void _stringToBytes(void* fill_buf, const std::string &s, ssize_t size);
 };
 
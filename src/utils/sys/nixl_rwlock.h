@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NIXL_RWLOCK_H
+#define _NIXL_RWLOCK_H
+
+#include <pthread.h>
+
+// Reader-writer lock, as std::shared_mutex is not available in C++11.
+// Writers are preferred, so a stream of readers cannot starve them.
+class nixlRWLock {
+    private:
+        pthread_rwlock_t rwlock;
+
+    public:
+        nixlRWLock() {
+            pthread_rwlockattr_t attr;
+            pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+            pthread_rwlockattr_setkind_np(&attr,
+                    PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+            pthread_rwlock_init(&rwlock, &attr);
+            pthread_rwlockattr_destroy(&attr);
+        }
+        ~nixlRWLock() { pthread_rwlock_destroy(&rwlock); }
+
+        nixlRWLock(const nixlRWLock&) = delete;
+        nixlRWLock& operator=(const nixlRWLock&) = delete;
+
+        // Same names as std::shared_mutex, so std::lock_guard works for writers
+        void lock() { pthread_rwlock_wrlock(&rwlock); }
+        void unlock() { pthread_rwlock_unlock(&rwlock); }
+        void lock_shared() { pthread_rwlock_rdlock(&rwlock); }
+        void unlock_shared() { pthread_rwlock_unlock(&rwlock); }
+};
+
+// Scoped shared (reader) ownership of a nixlRWLock
+class nixlSharedGuard {
+    private:
+        nixlRWLock &rwlock;
+
+    public:
+        nixlSharedGuard(nixlRWLock &lock) : rwlock(lock) { rwlock.lock_shared(); }
+        ~nixlSharedGuard() { rwlock.unlock_shared(); }
+
+        nixlSharedGuard(const nixlSharedGuard&) = delete;
+        nixlSharedGuard& operator=(const nixlSharedGuard&) = delete;
+};
+
+#endif
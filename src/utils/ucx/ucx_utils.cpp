@@ -47,7 +47,9 @@ nixlUcxContext::nixlUcxContext(std::vector<std::string> devs,
                                size_t req_size,
                                nixlUcxContext::req_cb_t init_cb,
                                nixlUcxContext::req_cb_t fini_cb,
-                               nixl_ucx_mt_t __mt_type)
+                               nixl_ucx_mt_t __mt_type,
+                               size_t num_eps,
+                               bool wakeup)
 {
     ucp_params_t ucp_params;
     ucp_config_t *ucp_config;
@@ -58,6 +60,8 @@ nixlUcxContext::nixlUcxContext(std::vector<std::string> devs,
     ucp_params.field_mask = UCP_PARAM_FIELD_FEATURES | UCP_PARAM_FIELD_MT_WORKERS_SHARED |
                             UCP_PARAM_FIELD_ESTIMATED_NUM_EPS;
     ucp_params.features = UCP_FEATURE_RMA | UCP_FEATURE_AMO32 | UCP_FEATURE_AMO64 | UCP_FEATURE_AM;
+    if (wakeup)
+        ucp_params.features |= UCP_FEATURE_WAKEUP;
     switch(mt_type) {
     case NIXL_UCX_MT_SINGLE:
     case NIXL_UCX_MT_WORKER:
@@ -70,7 +74,7 @@ nixlUcxContext::nixlUcxContext(std::vector<std::string> devs,
         assert(mt_type < NIXL_UCX_MT_MAX);
         abort();
     }
-    ucp_params.estimated_num_eps = 3;
+    ucp_params.estimated_num_eps = num_eps;
 
     if (req_size) {
         ucp_params.request_size = req_size;
@@ -189,7 +193,8 @@ static void err_cb(void *arg, ucp_ep_h ep, ucs_status_t status)
 }
 
 
-int nixlUcxWorker::connect(void* addr, size_t size, nixlUcxEp &ep)
+int nixlUcxWorker::connect(void* addr, size_t size, nixlUcxEp &ep,
+                           ucp_err_handler_cb_t ep_err_cb, void *err_arg)
 {
     ucp_ep_params_t ep_params;
     ucs_status_t status;
@@ -200,7 +205,8 @@ int nixlUcxWorker::connect(void* addr, size_t size, nixlUcxEp &ep)
                            UCP_EP_PARAM_FIELD_ERR_HANDLER |
                            UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE;
     ep_params.err_mode = UCP_ERR_HANDLING_MODE_PEER;
-    ep_params.err_handler.cb = err_cb;
+    ep_params.err_handler.cb = ep_err_cb ? ep_err_cb : err_cb;
+    ep_params.err_handler.arg = err_arg;
     ep_params.address = (ucp_address_t*) addr;
 
     status = ucp_ep_create(worker, &ep_params, &ep.eph);
@@ -238,9 +244,10 @@ int nixlUcxWorker::disconnect(nixlUcxEp &ep)
     return 0;
 }
 
-int nixlUcxWorker::disconnect_nb(nixlUcxEp &ep)
+int nixlUcxWorker::disconnect_nb(nixlUcxEp &ep, bool force)
 {
-    ucs_status_ptr_t request = ucp_ep_close_nb(ep.eph, UCP_EP_CLOSE_MODE_FLUSH);
+    ucs_status_ptr_t request = ucp_ep_close_nb(ep.eph, force ? UCP_EP_CLOSE_MODE_FORCE :
+                                                               UCP_EP_CLOSE_MODE_FLUSH);
 
     if (UCS_PTR_IS_ERR(request)) {
         //TODO: proper cleanup
@@ -370,16 +377,29 @@ int nixlUcxWorker::regAmCallback(unsigned msg_id, ucp_am_recv_callback_t cb, voi
     return 0;
 }
 
+static void setCallback(ucp_request_param_t &param,
+                        ucp_send_nbx_callback_t cb, void *cb_arg)
+{
+    if (cb) {
+        param.op_attr_mask |= UCP_OP_ATTR_FIELD_CALLBACK |
+                              UCP_OP_ATTR_FIELD_USER_DATA;
+        param.cb.send       = cb;
+        param.user_data     = cb_arg;
+    }
+}
+
 nixl_status_t nixlUcxWorker::sendAm(nixlUcxEp &ep, unsigned msg_id,
                                     void* hdr, size_t hdr_len,
                                     void* buffer, size_t len,
-                                    uint32_t flags, nixlUcxReq &req)
+                                    uint32_t flags, nixlUcxReq &req,
+                                    ucp_send_nbx_callback_t cb, void *cb_arg)
 {
     ucs_status_ptr_t request;
     ucp_request_param_t param = {0};
 
     param.op_attr_mask |= UCP_OP_ATTR_FIELD_FLAGS;
     param.flags         = flags;
+    setCallback(param, cb, cb_arg);
 
     request = ucp_am_send_nbx(ep.eph, msg_id, hdr, hdr_len, buffer, len, &param);
 
@@ -419,10 +439,25 @@ int nixlUcxWorker::progress()
     return ucp_worker_progress(worker);
 }
 
+int nixlUcxWorker::getEfd(int &fd)
+{
+    return (ucp_worker_get_efd(worker, &fd) == UCS_OK) ? 0 : -1;
+}
+
+int nixlUcxWorker::arm()
+{
+    ucs_status_t status = ucp_worker_arm(worker);
+
+    if (status == UCS_ERR_BUSY)
+        return 1;
+    return (status == UCS_OK) ? 0 : -1;
+}
+
 nixl_status_t nixlUcxWorker::read(nixlUcxEp &ep,
                                   uint64_t raddr, nixlUcxRkey &rk,
                                   void *laddr, nixlUcxMem &mem,
-                                  size_t size, nixlUcxReq &req)
+                                  size_t size, nixlUcxReq &req,
+                                  ucp_send_nbx_callback_t cb, void *cb_arg)
 {
     ucs_status_ptr_t request;
 
@@ -430,6 +465,7 @@ nixl_status_t nixlUcxWorker::read(nixlUcxEp &ep,
         .op_attr_mask               = UCP_OP_ATTR_FIELD_MEMH,
         .memh                       = mem.memh,
     };
+    setCallback(param, cb, cb_arg);
 
     request = ucp_get_nbx(ep.eph, laddr, size, raddr, rk.rkeyh, &param);
     if (request == NULL ) {
@@ -447,7 +483,8 @@ nixl_status_t nixlUcxWorker::read(nixlUcxEp &ep,
 nixl_status_t nixlUcxWorker::write(nixlUcxEp &ep,
                                    void *laddr, nixlUcxMem &mem,
                                    uint64_t raddr, nixlUcxRkey &rk,
-                                   size_t size, nixlUcxReq &req)
+                                   size_t size, nixlUcxReq &req,
+                                   ucp_send_nbx_callback_t cb, void *cb_arg)
 {
     ucs_status_ptr_t request;
 
@@ -455,6 +492,7 @@ nixl_status_t nixlUcxWorker::write(nixlUcxEp &ep,
         .op_attr_mask               = UCP_OP_ATTR_FIELD_MEMH,
         .memh                       = mem.memh,
     };
+    setCallback(param, cb, cb_arg);
 
     request = ucp_put_nbx(ep.eph, laddr, size, raddr, rk.rkeyh, &param);
     if (request == NULL ) {
@@ -469,6 +507,62 @@ nixl_status_t nixlUcxWorker::write(nixlUcxEp &ep,
     return NIXL_IN_PROG;
 }
 
+static nixl_status_t iovStatus(ucs_status_ptr_t request, nixlUcxReq &req)
+{
+    if (request == NULL ) {
+        return NIXL_SUCCESS;
+    } else if (UCS_PTR_IS_ERR(request)) {
+        switch (UCS_PTR_STATUS(request)) {
+        case UCS_ERR_UNSUPPORTED:
+        case UCS_ERR_INVALID_PARAM:
+            return NIXL_ERR_NOT_ALLOWED;
+        default:
+            return NIXL_ERR_BACKEND;
+        }
+    }
+
+    req = (void*)request;
+    return NIXL_IN_PROG;
+}
+
+nixl_status_t nixlUcxWorker::readv(nixlUcxEp &ep,
+                                   uint64_t raddr, nixlUcxRkey &rk,
+                                   const ucp_dt_iov_t *iov, size_t iov_cnt,
+                                   nixlUcxReq &req,
+                                   ucp_send_nbx_callback_t cb, void *cb_arg)
+{
+    ucs_status_ptr_t request;
+
+    // No memh: it only describes contiguous buffers, UCX looks the
+    // fragments up in its registration cache
+    ucp_request_param_t param = {
+        .op_attr_mask               = UCP_OP_ATTR_FIELD_DATATYPE,
+    };
+    param.datatype = ucp_dt_make_iov();
+    setCallback(param, cb, cb_arg);
+
+    request = ucp_get_nbx(ep.eph, (void*) iov, iov_cnt, raddr, rk.rkeyh, &param);
+    return iovStatus(request, req);
+}
+
+nixl_status_t nixlUcxWorker::writev(nixlUcxEp &ep,
+                                    const ucp_dt_iov_t *iov, size_t iov_cnt,
+                                    uint64_t raddr, nixlUcxRkey &rk,
+                                    nixlUcxReq &req,
+                                    ucp_send_nbx_callback_t cb, void *cb_arg)
+{
+    ucs_status_ptr_t request;
+
+    ucp_request_param_t param = {
+        .op_attr_mask               = UCP_OP_ATTR_FIELD_DATATYPE,
+    };
+    param.datatype = ucp_dt_make_iov();
+    setCallback(param, cb, cb_arg);
+
+    request = ucp_put_nbx(ep.eph, iov, iov_cnt, raddr, rk.rkeyh, &param);
+    return iovStatus(request, req);
+}
+
 nixl_status_t nixlUcxWorker::test(nixlUcxReq req)
 {
     ucs_status_t status;
@@ -491,12 +585,14 @@ nixl_status_t nixlUcxWorker::test(nixlUcxReq req)
     }
 }
 
-nixl_status_t nixlUcxWorker::flushEp(nixlUcxEp &ep, nixlUcxReq &req)
+nixl_status_t nixlUcxWorker::flushEp(nixlUcxEp &ep, nixlUcxReq &req,
+                                     ucp_send_nbx_callback_t cb, void *cb_arg)
 {
     ucp_request_param_t param;
     ucs_status_ptr_t request;
 
     param.op_attr_mask = 0;
+    setCallback(param, cb, cb_arg);
     request = ucp_ep_flush_nbx(ep.eph, &param);
 
     if (request == NULL ) {
@@ -511,6 +607,36 @@ nixl_status_t nixlUcxWorker::flushEp(nixlUcxEp &ep, nixlUcxReq &req)
     return NIXL_IN_PROG;
 }
 
+nixl_status_t nixlUcxWorker::fence()
+{
+    return (ucp_worker_fence(worker) == UCS_OK) ? NIXL_SUCCESS : NIXL_ERR_BACKEND;
+}
+
+nixl_status_t nixlUcxWorker::atomicAdd(nixlUcxEp &ep, const uint64_t *value,
+                                       uint64_t raddr, nixlUcxRkey &rk,
+                                       nixlUcxReq &req,
+                                       ucp_send_nbx_callback_t cb, void *cb_arg)
+{
+    ucs_status_ptr_t request;
+
+    ucp_request_param_t param = {
+        .op_attr_mask               = UCP_OP_ATTR_FIELD_DATATYPE,
+    };
+    param.datatype = ucp_dt_make_contig(sizeof(uint64_t));
+    setCallback(param, cb, cb_arg);
+
+    request = ucp_atomic_op_nbx(ep.eph, UCP_ATOMIC_OP_ADD, value, 1, raddr,
+                                rk.rkeyh, &param);
+    if (request == NULL ) {
+        return NIXL_SUCCESS;
+    } else if (UCS_PTR_IS_ERR(request)) {
+        return NIXL_ERR_BACKEND;
+    }
+
+    req = (void*)request;
+    return NIXL_IN_PROG;
+}
+
 void nixlUcxWorker::reqRelease(nixlUcxReq req)
 {
     ucp_request_free((void*)req);
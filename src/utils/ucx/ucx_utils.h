@@ -66,9 +66,12 @@ private:
 public:
 
     typedef void req_cb_t(void *request);
+    // num_eps is a hint for how many endpoints (peers) will be created.
+    // wakeup allows waiting on the workers' event fds.
     nixlUcxContext(std::vector<std::string> devices,
                    size_t req_size, req_cb_t init_cb, req_cb_t fini_cb,
-                   nixl_ucx_mt_t mt_type);
+                   nixl_ucx_mt_t mt_type, size_t num_eps = 3,
+                   bool wakeup = false);
     ~nixlUcxContext();
 
     static bool mtLevelIsSupproted(nixl_ucx_mt_t mt_type);
@@ -88,9 +91,13 @@ public:
 
     /* Connection */
     int epAddr(uint64_t &addr, size_t &size);
-    int connect(void* addr, size_t size, nixlUcxEp &ep);
+    // err_cb is called from progress if the peer fails, with err_arg, until
+    // the ep is closed. Without it, failures are only logged.
+    int connect(void* addr, size_t size, nixlUcxEp &ep,
+                ucp_err_handler_cb_t err_cb = NULL, void *err_arg = NULL);
     int disconnect(nixlUcxEp &ep);
-    int disconnect_nb(nixlUcxEp &ep);
+    // force fails the ops in flight instead of waiting for them
+    int disconnect_nb(nixlUcxEp &ep, bool force = false);
 
     /* Memory management */
     int memReg(void *addr, size_t size, nixlUcxMem &mem);
@@ -106,24 +113,57 @@ public:
     nixl_status_t sendAm(nixlUcxEp &ep, unsigned msg_id,
                          void* hdr, size_t hdr_len,
                          void* buffer, size_t len,
-                         uint32_t flags, nixlUcxReq &req);
+                         uint32_t flags, nixlUcxReq &req,
+                         ucp_send_nbx_callback_t cb = NULL, void *cb_arg = NULL);
     int getRndvData(void* data_desc, void* buffer, size_t len,
                     const ucp_request_param_t *param, nixlUcxReq &req);
 
     /* Data access */
+    // If cb is given, it is called from progress when an op that returned
+    // NIXL_IN_PROG completes, and req can be released right away
     int progress();
-    nixl_status_t flushEp(nixlUcxEp &ep, nixlUcxReq &req);
+    // Event fd for waiting on worker activity, needs a context with wakeup.
+    // arm returns 1 if events are already pending, so the fd shouldn't be
+    // waited on before progressing again.
+    int getEfd(int &fd);
+    int arm();
+    nixl_status_t flushEp(nixlUcxEp &ep, nixlUcxReq &req,
+                          ucp_send_nbx_callback_t cb = NULL, void *cb_arg = NULL);
+    // Orders ops posted after it behind the ones before, without waiting
+    nixl_status_t fence();
+    // Adds *value to the remote uint64_t, value must stay valid until completion
+    nixl_status_t atomicAdd(nixlUcxEp &ep, const uint64_t *value,
+                            uint64_t raddr, nixlUcxRkey &rk, nixlUcxReq &req,
+                            ucp_send_nbx_callback_t cb = NULL, void *cb_arg = NULL);
     nixl_status_t read(nixlUcxEp &ep,
                        uint64_t raddr, nixlUcxRkey &rk,
                        void *laddr, nixlUcxMem &mem,
-                       size_t size, nixlUcxReq &req);
+                       size_t size, nixlUcxReq &req,
+                       ucp_send_nbx_callback_t cb = NULL, void *cb_arg = NULL);
     nixl_status_t write(nixlUcxEp &ep,
                         void *laddr, nixlUcxMem &mem,
                         uint64_t raddr, nixlUcxRkey &rk,
-                        size_t size, nixlUcxReq &req);
+                        size_t size, nixlUcxReq &req,
+                        ucp_send_nbx_callback_t cb = NULL, void *cb_arg = NULL);
+    // Gather/scatter of local fragments to/from one remote-contiguous region.
+    // iov must stay valid until req completes. NIXL_ERR_NOT_ALLOWED if the
+    // transport can't do iov RMA, which most UCX versions refuse, so the
+    // caller can fall back to contig ops.
+    nixl_status_t readv(nixlUcxEp &ep,
+                        uint64_t raddr, nixlUcxRkey &rk,
+                        const ucp_dt_iov_t *iov, size_t iov_cnt,
+                        nixlUcxReq &req,
+                        ucp_send_nbx_callback_t cb = NULL, void *cb_arg = NULL);
+    nixl_status_t writev(nixlUcxEp &ep,
+                         const ucp_dt_iov_t *iov, size_t iov_cnt,
+                         uint64_t raddr, nixlUcxRkey &rk,
+                         nixlUcxReq &req,
+                         ucp_send_nbx_callback_t cb = NULL, void *cb_arg = NULL);
     nixl_status_t test(nixlUcxReq req);
 
-    void reqRelease(nixlUcxReq req);
+    // Also from the completion callback of req. A request with a callback
+    // is only freed there, UCX doesn't call it after the request is freed.
+    static void reqRelease(nixlUcxReq req);
     void reqCancel(nixlUcxReq req);
 };
 
@@ -16,6 +16,8 @@
  */
 #include <iostream>
 #include <cassert>
+#include <atomic>
+#include <thread>
 
 #include <sys/time.h>
 
@@ -33,6 +35,14 @@ void check_buf(void* buf, size_t len) {
     }
 }
 
+void count_notifs(const nixlNotifArena &notifs, void* arg) {
+    for (auto & rec : notifs.recs) {
+        assert(notifs.agents[rec.agentId] == agent1);
+        assert(std::string(notifs.msg(rec), rec.len) == "callback");
+    }
+    ((std::atomic<size_t>*) arg)->fetch_add(notifs.size());
+}
+
 bool equal_buf (void* buf1, void* buf2, size_t len) {
 
     // Do some checks on the data.
@@ -325,6 +335,9 @@ int main()
     nixlAgentConfig cfg(true);
     nixl_b_params_t init1, init2;
 
+    // Failed or timed out transfers are posted again up to twice
+    cfg.xferRetries = 2;
+
     // populate required/desired inits
     nixlAgent A1(agent1, cfg);
     nixlAgent A2(agent2, cfg);
@@ -443,6 +456,97 @@ int main()
 
     std::cout << "Transfer verified\n";
 
+    std::cout << "Performing signal test\n";
+    // Counter in Agent2's registered buffer, away from the transferred data
+    uint64_t* counter = (uint64_t*) (((char*) addr2) + 128);
+    ret1 = A1.setXferSignal(req_handle, nixlBasicDesc((uintptr_t) counter, sizeof(uint64_t), 0));
+    assert(ret1 == NIXL_SUCCESS);
+
+    for (uint64_t i = 1; i <= 3; i++) {
+        status = A1.postXferReq(req_handle);
+        while (status != NIXL_SUCCESS) {
+            status = A1.getXferStatus(req_handle);
+            assert(status >= 0);
+        }
+        // The transfer is flushed, so the add has landed by completion
+        assert(__atomic_load_n(counter, __ATOMIC_ACQUIRE) == i);
+        while (A2.getNotifs(notif_map) == 0);
+        notif_map[agent1].clear();
+    }
+
+    std::cout << "Signal verified\n";
+
+    std::cout << "Performing batched notification test\n";
+    nixlNotifArena arena;
+    for (int i = 0; i < 4; i++)
+        assert(A1.genNotif(agent2, "batch" + std::to_string(i)) == NIXL_SUCCESS);
+    while (arena.size() < 4)
+        assert(A2.getNotifs(arena) >= 0);
+    assert(arena.size() == 4);
+    for (size_t i = 0; i < arena.size(); i++) {
+        const nixl_notif_rec_t &rec = arena.recs[i];
+        assert(arena.agents[rec.agentId] == agent1);
+        assert(std::string(arena.msg(rec), rec.len) == "batch" + std::to_string(i));
+    }
+
+    std::atomic<size_t> cb_notifs(0);
+    assert(A2.setNotifCallback(count_notifs, &cb_notifs) == NIXL_SUCCESS);
+    for (int i = 0; i < 4; i++)
+        assert(A1.genNotif(agent2, "callback") == NIXL_SUCCESS);
+    while (cb_notifs < 4)
+        std::this_thread::yield();
+    assert(A2.setNotifCallback(nullptr, nullptr) == NIXL_SUCCESS);
+    assert(cb_notifs == 4);
+
+    std::cout << "Batched notifications verified\n";
+
+    std::cout << "Performing deadline test\n";
+    nixlXferReqH *req_handle3;
+    ret1 = A1.createXferReq(req_src_descs, req_dst_descs, agent2, "", NIXL_READ, req_handle3);
+    assert(ret1 == NIXL_SUCCESS);
+    assert(A1.getXferStatus(req_handle3) == NIXL_ERR_NOT_POSTED);
+
+    // A live peer completes well within the deadline
+    status = A1.postXferReq(req_handle3, 10000000);
+    while (status == NIXL_IN_PROG)
+        status = A1.getXferStatus(req_handle3);
+    assert(status == NIXL_SUCCESS);
+
+    // Canceling leaves the request reusable
+    status = A1.postXferReq(req_handle3, 10000000);
+    assert(status >= 0);
+    assert(A1.cancelXferReq(req_handle3) == NIXL_SUCCESS);
+    status = A1.getXferStatus(req_handle3);
+    assert(status == NIXL_SUCCESS || status == NIXL_ERR_NOT_POSTED);
+    status = A1.postXferReq(req_handle3);
+    while (status == NIXL_IN_PROG)
+        status = A1.getXferStatus(req_handle3);
+    assert(status == NIXL_SUCCESS);
+    A1.invalidateXferReq(req_handle3);
+
+    std::cout << "Deadlines verified\n";
+
+    std::cout << "Performing retry test\n";
+    nixlXferReqH *req_handle4;
+    ret1 = A1.createXferReq(req_src_descs, req_dst_descs, agent2, "", NIXL_READ, req_handle4);
+    assert(ret1 == NIXL_SUCCESS);
+
+    // Each attempt gets the timeout, unless one completes the request
+    // times out after the retries
+    status = A1.postXferReq(req_handle4, 1);
+    while (status == NIXL_IN_PROG)
+        status = A1.getXferStatus(req_handle4);
+    assert(status == NIXL_SUCCESS || status == NIXL_ERR_TIMEOUT);
+
+    // Retries don't carry over to the next post
+    status = A1.postXferReq(req_handle4);
+    while (status == NIXL_IN_PROG)
+        status = A1.getXferStatus(req_handle4);
+    assert(status == NIXL_SUCCESS);
+    A1.invalidateXferReq(req_handle4);
+
+    std::cout << "Retries verified\n";
+
     std::cout << "performing sideXferTest with backends " << ucx1 << " " << ucx2 << "\n";
     ret1 = sideXferTest(&A1, &A2, req_handle, ucx2);
     assert(ret1 == NIXL_SUCCESS);
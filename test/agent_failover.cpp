@@ -0,0 +1,300 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Retries of a transfer moving from a failing backend to another one, with
+// two in-process loopback backends registered as static plugins. Each handle
+// has to go back to the backend that made it. Also checks a request of a
+// nixlXferContext reused after release, and a handle reused by makeXferReq
+// for another remote agent, don't keep the previous signal.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstring>
+
+#include "nixl.h"
+#include "backend/backend_plugin.h"
+#include "internal/plugin_manager.h"
+
+class loopbackMD : public nixlBackendMD {
+    public:
+        loopbackMD(bool is_private) : nixlBackendMD(is_private) {}
+};
+
+class loopbackReqH : public nixlBackendReqH {
+    public:
+        const nixlBackendEngine* owner;
+        int                      polls;
+};
+
+// Copies within the process when checked, or fails every transfer
+template <bool BROKEN>
+class loopbackEngine : public nixlBackendEngine {
+    public:
+        static int liveHandles;
+
+        loopbackEngine(const nixlBackendInitParams* init) : nixlBackendEngine(init) {}
+
+        bool supportsRemote () const { return true; }
+        bool supportsLocal () const { return true; }
+        bool supportsNotif () const { return false; }
+        bool supportsProgTh () const { return false; }
+        bool supportsSignal () const { return true; }
+
+        nixl_status_t registerMem (const nixlStringDesc &mem, const nixl_mem_t &nixl_mem,
+                                   nixlBackendMD* &out) {
+            out = new loopbackMD(true);
+            return NIXL_SUCCESS;
+        }
+        void deregisterMem (nixlBackendMD* meta) { delete meta; }
+
+        nixl_status_t connect(const std::string &remote_agent) { return NIXL_SUCCESS; }
+        nixl_status_t disconnect(const std::string &remote_agent) { return NIXL_SUCCESS; }
+        nixl_status_t unloadMD (nixlBackendMD* input) { delete input; return NIXL_SUCCESS; }
+
+        std::string getPublicData (const nixlBackendMD* meta) const { return "loopback"; }
+        std::string getConnInfo() const { return "loopback"; }
+        nixl_status_t loadRemoteConnInfo (const std::string &remote_agent,
+                                          const std::string &remote_conn_info) {
+            return NIXL_SUCCESS;
+        }
+        nixl_status_t loadRemoteMD (const nixlStringDesc &input, const nixl_mem_t &nixl_mem,
+                                    const std::string &remote_agent, nixlBackendMD* &output) {
+            output = new loopbackMD(false);
+            return NIXL_SUCCESS;
+        }
+        nixl_status_t loadLocalMD (nixlBackendMD* input, nixlBackendMD* &output) {
+            output = new loopbackMD(false);
+            return NIXL_SUCCESS;
+        }
+
+        nixl_status_t postXfer (const nixl_meta_dlist_t &local, const nixl_meta_dlist_t &remote,
+                                const nixl_xfer_op_t &operation, const std::string &remote_agent,
+                                const std::string &notif_msg, nixlBackendReqH* &handle) {
+            loopbackReqH* req = new loopbackReqH;
+            req->owner = this;
+            req->polls = 0;
+            liveHandles++;
+            handle = req;
+
+            for (int i = 0; !BROKEN && (i < local.descCount()); i++) {
+                void* src = (void*) local[i].addr;
+                void* dst = (void*) remote[i].addr;
+                if (operation == NIXL_READ)
+                    std::swap(src, dst);
+                memcpy(dst, src, local[i].len);
+            }
+            return NIXL_IN_PROG;
+        }
+        nixl_status_t postXferSignal (const nixl_meta_dlist_t &local,
+                                      const nixl_meta_dlist_t &remote,
+                                      const nixl_xfer_op_t &operation,
+                                      const std::string &remote_agent,
+                                      const std::string &notif_msg,
+                                      const nixlMetaDesc &signal,
+                                      nixlBackendReqH* &handle) {
+            nixl_status_t ret = postXfer(local, remote, operation, remote_agent,
+                                         notif_msg, handle);
+            if (!BROKEN)
+                (*(uint64_t*) signal.addr)++;
+            return ret;
+        }
+        nixl_status_t checkXfer(nixlBackendReqH* handle) {
+            loopbackReqH* req = (loopbackReqH*) handle;
+            assert(req->owner == this);
+            if (++req->polls < 2)
+                return NIXL_IN_PROG;
+            return BROKEN ? NIXL_ERR_BACKEND : NIXL_SUCCESS;
+        }
+        void releaseReqH(nixlBackendReqH* handle) {
+            loopbackReqH* req = (loopbackReqH*) handle;
+            assert(req->owner == this);
+            liveHandles--;
+            delete req;
+        }
+};
+
+template <bool BROKEN> int loopbackEngine<BROKEN>::liveHandles = 0;
+typedef loopbackEngine<false> goodEngine;
+typedef loopbackEngine<true>  brokenEngine;
+
+static nixlBackendEngine* createGood(const nixlBackendInitParams* init) {
+    return new goodEngine(init);
+}
+static nixlBackendEngine* createBroken(const nixlBackendInitParams* init) {
+    return new brokenEngine(init);
+}
+static void destroyEngine(nixlBackendEngine* engine) { delete engine; }
+static const char* goodName() { return "LOOPBACK"; }
+static const char* brokenName() { return "BROKEN"; }
+static const char* pluginVersion() { return "0.1"; }
+static nixl_b_params_t pluginOptions() { return nixl_b_params_t(); }
+
+static nixlBackendPlugin goodPlugin = {NIXL_PLUGIN_API_VERSION, createGood,
+                                       destroyEngine, goodName, pluginVersion,
+                                       pluginOptions};
+static nixlBackendPlugin brokenPlugin = {NIXL_PLUGIN_API_VERSION, createBroken,
+                                         destroyEngine, brokenName, pluginVersion,
+                                         pluginOptions};
+static nixlBackendPlugin* goodCreator() { return &goodPlugin; }
+static nixlBackendPlugin* brokenCreator() { return &brokenPlugin; }
+
+static nixl_status_t waitXfer(nixlAgent &agent, nixlXferReqH* req) {
+    nixl_status_t ret = agent.postXferReq(req);
+    while (ret == NIXL_IN_PROG)
+        ret = agent.getXferStatus(req);
+    return ret;
+}
+
+int main()
+{
+    nixlPluginManager::registerStaticPlugin("LOOPBACK", goodCreator);
+    nixlPluginManager::registerStaticPlugin("BROKEN", brokenCreator);
+
+    nixlAgentConfig cfg(false);
+    cfg.xferRetries = 1;
+    std::vector<char> src(4096, 'a'), dst(4096, 0);
+
+    {
+        nixlAgent A1("Agent001", cfg);
+        nixlAgent A2("Agent002", cfg);
+        nixlBackendH* broken1 = A1.createBackend("BROKEN", nixl_b_params_t());
+        nixlBackendH* good1   = A1.createBackend("LOOPBACK", nixl_b_params_t());
+        nixlBackendH* broken2 = A2.createBackend("BROKEN", nixl_b_params_t());
+        nixlBackendH* good2   = A2.createBackend("LOOPBACK", nixl_b_params_t());
+        assert(broken1 && good1 && broken2 && good2);
+
+        nixl_reg_dlist_t src_reg(DRAM_SEG), dst_reg(DRAM_SEG);
+        src_reg.addDesc(nixlStringDesc((uintptr_t) src.data(), src.size(), 0, ""));
+        dst_reg.addDesc(nixlStringDesc((uintptr_t) dst.data(), dst.size(), 0, ""));
+        assert(A2.registerMem(dst_reg, broken2) == NIXL_SUCCESS);
+        assert(A2.registerMem(dst_reg, good2) == NIXL_SUCCESS);
+        assert(A1.loadRemoteMD(A2.getLocalMD()) == "Agent002");
+
+        // Only the broken backend has the source when the request is made,
+        // so it's picked, and the other one when it's retried
+        assert(A1.registerMem(src_reg, broken1) == NIXL_SUCCESS);
+        nixl_xfer_dlist_t src_descs = src_reg.trim();
+        nixl_xfer_dlist_t dst_descs = dst_reg.trim();
+        nixlXferReqH* req;
+        assert(A1.createXferReq(src_descs, dst_descs, "Agent002", "", NIXL_WRITE,
+                                req) == NIXL_SUCCESS);
+        assert(A1.getXferBackend(req) == broken1);
+        assert(A1.registerMem(src_reg, good1) == NIXL_SUCCESS);
+
+        assert(waitXfer(A1, req) == NIXL_SUCCESS);
+        assert(A1.getXferBackend(req) == good1);
+        assert(brokenEngine::liveHandles == 0);
+        assert(memcmp(src.data(), dst.data(), src.size()) == 0);
+        std::cout << "Failed over from BROKEN to LOOPBACK" << std::endl;
+
+        // It stays on the new backend for later posts
+        src.assign(src.size(), 'b');
+        assert(waitXfer(A1, req) == NIXL_SUCCESS);
+        assert(A1.getXferBackend(req) == good1);
+        assert(memcmp(src.data(), dst.data(), src.size()) == 0);
+
+        // Without retries left on a given backend, the error is returned
+        nixlXferReqH* pinned;
+        assert(A1.createXferReq(src_descs, dst_descs, "Agent002", "", NIXL_WRITE,
+                                pinned, broken1) == NIXL_SUCCESS);
+        assert(waitXfer(A1, pinned) == NIXL_ERR_BACKEND);
+        assert(A1.getXferBackend(pinned) == broken1);
+
+        A1.invalidateXferReq(pinned);
+        A1.invalidateXferReq(req);
+        assert((brokenEngine::liveHandles == 0) && (goodEngine::liveHandles == 0));
+
+        // A released context request is handed out again, without its signal
+        uint64_t counter = 0;
+        nixl_reg_dlist_t counter_reg(DRAM_SEG);
+        counter_reg.addDesc(nixlStringDesc((uintptr_t) &counter, sizeof(counter), 0, ""));
+        assert(A2.registerMem(counter_reg, good2) == NIXL_SUCCESS);
+        assert(A1.loadRemoteMD(A2.getLocalMD()) == "Agent002");
+        {
+            nixlXferContext ctx(A1);
+            nixlXferReqH *signaled, *reused;
+            assert(ctx.createXferReq(src_descs, dst_descs, "Agent002", "", NIXL_WRITE,
+                                     signaled, good1) == NIXL_SUCCESS);
+            assert(A1.setXferSignal(signaled, counter_reg[0]) == NIXL_SUCCESS);
+            assert(waitXfer(A1, signaled) == NIXL_SUCCESS);
+            assert(counter == 1);
+            ctx.releaseXferReq(signaled);
+
+            assert(ctx.createXferReq(src_descs, dst_descs, "Agent002", "", NIXL_WRITE,
+                                     reused, good1) == NIXL_SUCCESS);
+            assert(reused == signaled);
+            assert(waitXfer(A1, reused) == NIXL_SUCCESS);
+            assert(counter == 1);
+            ctx.releaseXferReq(reused);
+        }
+        std::cout << "Reused context request without its signal" << std::endl;
+
+        // A handle reused by makeXferReq for another remote agent drops the
+        // signal it had for the first one
+        {
+            nixlAgent A3("Agent003", cfg);
+            nixlBackendH* good3 = A3.createBackend("LOOPBACK", nixl_b_params_t());
+            std::vector<char> dst3(src.size(), 0);
+            nixl_reg_dlist_t dst3_reg(DRAM_SEG);
+            dst3_reg.addDesc(nixlStringDesc((uintptr_t) dst3.data(), dst3.size(), 0, ""));
+            assert(A3.registerMem(dst3_reg, good3) == NIXL_SUCCESS);
+            assert(A1.loadRemoteMD(A3.getLocalMD()) == "Agent003");
+
+            nixlXferSideH *local_side, *remote2_side, *remote3_side;
+            assert(A1.prepXferSide(src_descs, "", good1, local_side) == NIXL_SUCCESS);
+            assert(A1.prepXferSide(dst_descs, "Agent002", good1, remote2_side) == NIXL_SUCCESS);
+            assert(A1.prepXferSide(dst3_reg.trim(), "Agent003", good1, remote3_side) ==
+                   NIXL_SUCCESS);
+
+            int index = 0;
+            nixlXferReqH* handle = nullptr;
+            assert(A1.makeXferReq(local_side, &index, remote2_side, &index, 1, "",
+                                  NIXL_WRITE, handle) == NIXL_SUCCESS);
+            assert(A1.setXferSignal(handle, counter_reg[0]) == NIXL_SUCCESS);
+            assert(waitXfer(A1, handle) == NIXL_SUCCESS);
+            assert(counter == 2);
+
+            nixlXferReqH* first = handle;
+            src.assign(src.size(), 'c');
+            assert(A1.makeXferReq(local_side, &index, remote3_side, &index, 1, "",
+                                  NIXL_WRITE, handle) == NIXL_SUCCESS);
+            assert(handle == first);
+            assert(waitXfer(A1, handle) == NIXL_SUCCESS);
+            assert(counter == 2);
+            assert(memcmp(src.data(), dst3.data(), src.size()) == 0);
+
+            A1.invalidateXferReq(handle);
+            A1.invalidateXferSide(remote3_side);
+            A1.invalidateXferSide(remote2_side);
+            A1.invalidateXferSide(local_side);
+            A1.invalidateRemoteMD("Agent003");
+            A3.deregisterMem(dst3_reg, good3);
+        }
+        std::cout << "Reused makeXferReq handle without its signal" << std::endl;
+        A2.deregisterMem(counter_reg, good2);
+        A1.invalidateRemoteMD("Agent002");
+        A1.deregisterMem(src_reg, good1);
+        A1.deregisterMem(src_reg, broken1);
+        A2.deregisterMem(dst_reg, good2);
+        A2.deregisterMem(dst_reg, broken2);
+    }
+
+    std::cout << "Test done" << std::endl;
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Creates transfer requests from many threads on one agent, first alone to
+// see how it scales with the thread count, then while another thread keeps
+// invalidating and reloading the remote agent's metadata. Each is run with
+// the agent's createXferReq, and with a nixlXferContext per thread.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <sys/time.h>
+
+#include "nixl.h"
+
+#define NUM_BLOCKS  1024
+#define BLOCK_SIZE  4096
+#define REQ_DESCS   16
+
+std::string agent1("Agent001");
+std::string agent2("Agent002");
+
+struct workerStats {
+    long created  = 0;
+    long notFound = 0;
+};
+
+static float elapsedUs(struct timeval &start_time, struct timeval &end_time)
+{
+    struct timeval diff_time;
+    timersub(&end_time, &start_time, &diff_time);
+    return (diff_time.tv_sec * 1000000) + diff_time.tv_usec;
+}
+
+void worker(nixlAgent* agent, nixlBackendH* backend, int id, int iters,
+            bool use_ctx, void* src_buf, void* dst_buf, workerStats &stats)
+{
+    nixl_xfer_dlist_t src_list(DRAM_SEG), dst_list(DRAM_SEG);
+    nixlXferContext ctx(*agent);
+    unsigned int seed = id;
+    nixlXferReqH* req;
+    nixl_status_t ret;
+
+    for (int i = 0; i < iters; i++) {
+        src_list.clear();
+        dst_list.clear();
+        // Random blocks, so different threads touch different remote metadata
+        for (int j = 0; j < REQ_DESCS; j++) {
+            size_t offset = (rand_r(&seed) % NUM_BLOCKS) * BLOCK_SIZE;
+            src_list.addDesc(nixlBasicDesc((uintptr_t) src_buf + offset, BLOCK_SIZE, 0));
+            dst_list.addDesc(nixlBasicDesc((uintptr_t) dst_buf + offset, BLOCK_SIZE, 0));
+        }
+
+        if (use_ctx)
+            ret = ctx.createXferReq(src_list, dst_list, agent2, "", NIXL_WRITE,
+                                    req, backend);
+        else
+            ret = agent->createXferReq(src_list, dst_list, agent2, "", NIXL_WRITE,
+                                       req, backend);
+        if (ret == NIXL_ERR_NOT_FOUND) { // Invalidated by the control thread
+            stats.notFound++;
+            continue;
+        }
+        assert(ret == NIXL_SUCCESS);
+        if (use_ctx)
+            ctx.releaseXferReq(req);
+        else
+            agent->invalidateXferReq(req);
+        stats.created++;
+    }
+}
+
+void runWorkers(nixlAgent* agent, nixlBackendH* backend, int num_threads,
+                int iters, bool use_ctx, void* src_buf, void* dst_buf,
+                const std::string &remote_md, bool with_control)
+{
+    std::vector<std::thread> threads;
+    std::vector<workerStats> stats(num_threads);
+    std::atomic<bool> done(false);
+    std::thread control;
+    long reloads = 0, created = 0, not_found = 0;
+    struct timeval start_time, end_time;
+
+    if (with_control) {
+        control = std::thread([&]() {
+            while (!done) {
+                assert(agent->invalidateRemoteMD(agent2) == NIXL_SUCCESS);
+                assert(agent->loadRemoteMD(remote_md) == agent2);
+                reloads++;
+            }
+        });
+    }
+
+    gettimeofday(&start_time, NULL);
+    for (int t = 0; t < num_threads; t++)
+        threads.emplace_back(worker, agent, backend, t, iters, use_ctx,
+                             src_buf, dst_buf, std::ref(stats[t]));
+    for (auto & th : threads)
+        th.join();
+    gettimeofday(&end_time, NULL);
+
+    if (with_control) {
+        done = true;
+        control.join();
+    }
+
+    for (auto & s : stats) {
+        created += s.created;
+        not_found += s.notFound;
+    }
+    assert(created + not_found == (long) num_threads * iters);
+
+    float us = elapsedUs(start_time, end_time);
+    std::cout << (use_ctx ? "context, " : "agent, ")
+              << (with_control ? "with reloads, " : "") << num_threads
+              << " threads: " << created << " requests in " << us / 1000
+              << "ms, " << created / us << " Mreqs/s";
+    if (with_control)
+        std::cout << ", " << reloads << " reloads, " << not_found
+                  << " requests found no remote";
+    std::cout << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int iters = 100000;
+    std::vector<int> thread_counts = {1, 2, 4, 8, 16};
+
+    // agent_mt_stress [iterations per thread]
+    if (argc > 1)
+        iters = atoi(argv[1]);
+    assert(iters > 0);
+
+    nixlAgentConfig cfg(true);
+    nixlAgent A1(agent1, cfg);
+    nixlAgent A2(agent2, cfg);
+
+    nixlBackendH* ucx1 = A1.createBackend("UCX", A1.getBackendOptions("UCX"));
+    nixlBackendH* ucx2 = A2.createBackend("UCX", A2.getBackendOptions("UCX"));
+    assert(ucx1 != nullptr && ucx2 != nullptr);
+
+    void* src_buf = calloc(NUM_BLOCKS, BLOCK_SIZE);
+    void* dst_buf = calloc(NUM_BLOCKS, BLOCK_SIZE);
+    nixl_reg_dlist_t src_mem(DRAM_SEG), dst_mem(DRAM_SEG);
+
+    // One registration per block, so each has its own remote metadata
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        src_mem.addDesc(nixlStringDesc((uintptr_t) src_buf + i*BLOCK_SIZE, BLOCK_SIZE, 0));
+        dst_mem.addDesc(nixlStringDesc((uintptr_t) dst_buf + i*BLOCK_SIZE, BLOCK_SIZE, 0));
+    }
+    assert(A1.registerMem(src_mem, ucx1) == NIXL_SUCCESS);
+    assert(A2.registerMem(dst_mem, ucx2) == NIXL_SUCCESS);
+
+    std::string remote_md = A2.getLocalMD();
+    assert(A1.loadRemoteMD(remote_md) == agent2);
+
+    for (bool use_ctx : {false, true}) {
+        for (auto & count : thread_counts)
+            runWorkers(&A1, ucx1, count, iters, use_ctx, src_buf, dst_buf,
+                       remote_md, false);
+
+        for (auto & count : thread_counts)
+            runWorkers(&A1, ucx1, count, iters / 10, use_ctx, src_buf, dst_buf,
+                       remote_md, true);
+    }
+
+    assert(A1.invalidateRemoteMD(agent2) == NIXL_SUCCESS);
+    assert(A1.deregisterMem(src_mem, ucx1) == NIXL_SUCCESS);
+    assert(A2.deregisterMem(dst_mem, ucx2) == NIXL_SUCCESS);
+    free(src_buf);
+    free(dst_buf);
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the UCX engine's own progress thread with the agent's progress
+// thread, spinning and blocking on the worker's event fd when idle. Two agents
+// in the same process: reports the CPU used by the process while idle, and the
+// latency of a notification until the target's callback sees it.
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cassert>
+#include <cstdlib>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "nixl.h"
+
+std::string agent1("Agent001");
+std::string agent2("Agent002");
+
+static void count_notifs(const nixlNotifArena &notifs, void* arg) {
+    ((std::atomic<size_t>*) arg)->fetch_add(notifs.size());
+}
+
+static double cpuUs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000.0 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static double wallUs() {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec * 1000000.0 + now.tv_usec;
+}
+
+void runMode(const std::string &name, bool agent_thread, uint64_t wait_ms,
+             int iters)
+{
+    nixlAgentConfig cfg(true);
+    cfg.agentProgThread = agent_thread;
+    cfg.pthrWaitMs      = wait_ms;
+
+    nixlAgent A1(agent1, cfg);
+    nixlAgent A2(agent2, cfg);
+    nixlBackendH* ucx1 = A1.createBackend("UCX", A1.getBackendOptions("UCX"));
+    nixlBackendH* ucx2 = A2.createBackend("UCX", A2.getBackendOptions("UCX"));
+    assert(ucx1 && ucx2);
+    assert(A1.loadRemoteMD(A2.getLocalMD()) == agent2);
+
+    std::atomic<size_t> received(0);
+    assert(A2.setNotifCallback(count_notifs, &received) == NIXL_SUCCESS);
+
+    // Warm up the connection
+    assert(A1.genNotif(agent2, "warmup") == NIXL_SUCCESS);
+    while (received < 1)
+        std::this_thread::yield();
+
+    double cpu_start = cpuUs(), wall_start = wallUs();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    double idle_cpu = (cpuUs() - cpu_start) * 100 / (wallUs() - wall_start);
+
+    double lat_start = wallUs();
+    for (int i = 0; i < iters; i++) {
+        assert(A1.genNotif(agent2, "ping") == NIXL_SUCCESS);
+        while (received < (size_t) i + 2)
+            std::this_thread::yield();
+    }
+    double lat = (wallUs() - lat_start) / iters;
+
+    std::cout << name << ": idle CPU " << idle_cpu << "% of a core, "
+              << "notification latency " << lat << "us" << std::endl;
+
+    assert(A2.setNotifCallback(nullptr, nullptr) == NIXL_SUCCESS);
+    A1.invalidateRemoteMD(agent2);
+}
+
+int main(int argc, char **argv)
+{
+    int iters = 10000;
+
+    // agent_progress [iterations]
+    if (argc > 1)
+        iters = atoi(argv[1]);
+    assert(iters > 0);
+
+    runMode("backend threads     ", false, 0, iters);
+    runMode("agent thread, spin  ", true, 0, iters);
+    runMode("agent thread, wait  ", true, 10, iters);
+
+    return 0;
+}
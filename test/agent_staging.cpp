@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Writes a local file to another agent's memory, which no backend can do
+// directly: GDS has the file and UCX the remote agent. Compares the rate of
+// the two direct legs on their own, FILE to VRAM with GDS and VRAM to the
+// remote agent with UCX, with the staged transfer through VRAM buffers, with
+// one buffer and double buffered. Also compares a chain of GDS and UCX made
+// with createXferChain against the same two hops as separate requests per
+// chunk, which the application runs one after the other. Two agents in the
+// same process. A side no backend has fails as it would without staging.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <cuda_runtime.h>
+
+#include "nixl.h"
+
+std::string agent1("Agent001");
+std::string agent2("Agent002");
+
+static double wallUs() {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec * 1000000.0 + now.tv_usec;
+}
+
+// Rate in MB/s of running req to completion iters times
+static double runRate(nixlAgent &agent, nixlXferReqH* req, size_t len, int iters)
+{
+    double start = wallUs();
+    for (int i = 0; i < iters; i++) {
+        nixl_status_t ret = agent.postXferReq(req);
+        while (ret == NIXL_IN_PROG)
+            ret = agent.getXferStatus(req);
+        assert(ret == NIXL_SUCCESS);
+    }
+    return (double) len * iters / (wallUs() - start);
+}
+
+void runMode(const std::string &path, size_t len, void *staging, size_t chunk,
+             uint32_t depth, int iters)
+{
+    nixlAgentConfig cfg(true);
+    cfg.agentProgThread = true;
+    cfg.stagingDepth    = depth;
+
+    nixlAgent A1(agent1, cfg);
+    nixlAgent A2(agent2, cfg);
+    nixlBackendH* gds  = A1.createBackend("GDS", nixl_b_params_t());
+    nixlBackendH* ucx1 = A1.createBackend("UCX", A1.getBackendOptions("UCX"));
+    nixlBackendH* ucx2 = A2.createBackend("UCX", A2.getBackendOptions("UCX"));
+    assert(gds && ucx1 && ucx2);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0744);
+    assert(fd >= 0);
+    std::vector<char> data(len);
+    for (size_t i = 0; i < len; i++)
+        data[i] = (char) (i * 7 + 1);
+    assert(pwrite(fd, data.data(), len, 0) == (ssize_t) len);
+
+    void *vram, *dst_buf;
+    assert(cudaMalloc(&vram, len) == cudaSuccess);
+    dst_buf = calloc(1, len);
+
+    nixl_reg_dlist_t file_reg(FILE_SEG, false), vram_reg(VRAM_SEG), dst_reg(DRAM_SEG);
+    file_reg.addDesc(nixlStringDesc(0, len, fd));
+    vram_reg.addDesc(nixlStringDesc((uintptr_t) vram, len, 0));
+    dst_reg.addDesc(nixlStringDesc((uintptr_t) dst_buf, len, 0));
+    assert(A1.registerMem(file_reg, gds) == NIXL_SUCCESS);
+    assert(A1.registerMem(vram_reg, gds) == NIXL_SUCCESS);
+    assert(A1.registerMem(vram_reg, ucx1) == NIXL_SUCCESS);
+    assert(A2.registerMem(dst_reg, ucx2) == NIXL_SUCCESS);
+    assert(A1.loadRemoteMD(A2.getLocalMD()) == agent2);
+
+    nixl_xfer_dlist_t file_descs = file_reg.trim();
+    nixl_xfer_dlist_t vram_descs = vram_reg.trim();
+    nixl_xfer_dlist_t dst_descs  = dst_reg.trim();
+    nixlXferReqH *storage_req, *network_req, *staged_req;
+
+    assert(A1.createXferReq(vram_descs, file_descs, agent1, "", NIXL_READ,
+                            storage_req, gds) == NIXL_SUCCESS);
+    assert(A1.createXferReq(vram_descs, dst_descs, agent2, "", NIXL_WRITE,
+                            network_req, ucx1) == NIXL_SUCCESS);
+    double storage_rate = runRate(A1, storage_req, len, iters);
+    double network_rate = runRate(A1, network_req, len, iters);
+
+    // Without staging buffers there's no path from the file to the agent
+    assert(A1.createXferReq(file_descs, dst_descs, agent2, "", NIXL_WRITE,
+                            staged_req) == NIXL_ERR_NOT_FOUND);
+
+    nixl_reg_dlist_t staging_reg(VRAM_SEG);
+    staging_reg.addDesc(nixlStringDesc((uintptr_t) staging, chunk, 0));
+    staging_reg.addDesc(nixlStringDesc((uintptr_t) staging + chunk, chunk, 0));
+    assert(A1.addStagingBuffers(staging_reg) == NIXL_SUCCESS);
+
+    // Staging can't help a side that no backend has, and doesn't hide that
+    nixl_xfer_dlist_t past_dst(DRAM_SEG);
+    past_dst.addDesc(nixlBasicDesc((uintptr_t) dst_buf + len, len, 0));
+    assert(A1.createXferReq(file_descs, past_dst, agent2, "", NIXL_WRITE,
+                            staged_req) == NIXL_ERR_NOT_FOUND);
+
+    assert(A1.createXferReq(file_descs, dst_descs, agent2, "", NIXL_WRITE,
+                            staged_req) == NIXL_SUCCESS);
+    double staged_rate = runRate(A1, staged_req, len, iters);
+    assert(memcmp(dst_buf, data.data(), len) == 0);
+
+    std::cout << len << "B file, " << chunk << "B chunks, depth " << depth
+              << ": FILE->VRAM " << storage_rate << " MB/s, VRAM->remote "
+              << network_rate << " MB/s, both in turn "
+              << 1 / (1 / storage_rate + 1 / network_rate) << " MB/s, staged "
+              << staged_rate << " MB/s" << std::endl;
+
+    A1.invalidateXferReq(staged_req);
+
+    // Each chunk read into the first staging buffer, then written out of it
+    std::vector<nixlXferReqH*> hops;
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t cur = std::min(chunk, len - off);
+        nixl_xfer_dlist_t file_chunk(FILE_SEG, false), stage_chunk(VRAM_SEG);
+        nixl_xfer_dlist_t dst_chunk(DRAM_SEG);
+        file_chunk.addDesc(nixlBasicDesc(off, cur, fd));
+        stage_chunk.addDesc(nixlBasicDesc((uintptr_t) staging, cur, 0));
+        dst_chunk.addDesc(nixlBasicDesc((uintptr_t) dst_buf + off, cur, 0));
+        nixlXferReqH *read_req, *write_req;
+        assert(A1.createXferReq(stage_chunk, file_chunk, agent1, "", NIXL_READ,
+                                read_req, gds) == NIXL_SUCCESS);
+        assert(A1.createXferReq(stage_chunk, dst_chunk, agent2, "", NIXL_WRITE,
+                                write_req, ucx1) == NIXL_SUCCESS);
+        hops.push_back(read_req);
+        hops.push_back(write_req);
+    }
+    memset(dst_buf, 0, len);
+    double start = wallUs();
+    for (int i = 0; i < iters; i++) {
+        for (auto & req : hops) {
+            nixl_status_t ret = A1.postXferReq(req);
+            while (ret == NIXL_IN_PROG)
+                ret = A1.getXferStatus(req);
+            assert(ret == NIXL_SUCCESS);
+        }
+    }
+    double hops_rate = (double) len * iters / (wallUs() - start);
+    assert(memcmp(dst_buf, data.data(), len) == 0);
+    for (auto & req : hops)
+        A1.invalidateXferReq(req);
+
+    nixlXferReqH* chain_req;
+    assert(A1.createXferChain(file_descs, dst_descs, agent2, "", NIXL_WRITE,
+                              chain_req, gds, ucx1) == NIXL_SUCCESS);
+    memset(dst_buf, 0, len);
+    double chain_rate = runRate(A1, chain_req, len, iters);
+    assert(memcmp(dst_buf, data.data(), len) == 0);
+
+    std::cout << "    hops sequenced by the application " << hops_rate
+              << " MB/s, chain " << chain_rate << " MB/s" << std::endl;
+
+    A1.invalidateXferReq(chain_req);
+    A1.invalidateXferReq(storage_req);
+    A1.invalidateXferReq(network_req);
+    A1.invalidateRemoteMD(agent2);
+    A1.deregisterMem(vram_reg, ucx1);
+    A1.deregisterMem(vram_reg, gds);
+    A1.deregisterMem(file_reg, gds);
+    A2.deregisterMem(dst_reg, ucx2);
+    close(fd);
+    unlink(path.c_str());
+    cudaFree(vram);
+    free(dst_buf);
+}
+
+int main(int argc, char **argv)
+{
+    size_t len   = 256 * 1024 * 1024;
+    size_t chunk = 8 * 1024 * 1024;
+    int iters    = 10;
+
+    // agent_staging <directory> [chunk size] [iterations]
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0]
+                  << " <directory> [chunk size] [iterations]" << std::endl;
+        return 1;
+    }
+    if (argc > 2)
+        chunk = strtoull(argv[2], NULL, 10);
+    if (argc > 3)
+        iters = atoi(argv[3]);
+    assert(chunk > 0 && iters > 0);
+
+    // The agents deregister their staging buffers when they're destroyed
+    void *staging;
+    assert(cudaMalloc(&staging, 2 * chunk) == cudaSuccess);
+
+    std::string path = std::string(argv[1]) + "/agent_staging_file";
+    runMode(path, len, staging, chunk, 1, iters);
+    runMode(path, len, staging, chunk, 2, iters);
+
+    cudaFree(staging);
+
+    return 0;
+}
@@ -17,11 +17,23 @@
 #include <iostream>
 #include <string>
 #include <cassert>
+#include <climits>
 #include "nixl.h"
 #include "utils/serdes/serdes.h"
 #include "backend/backend_aux.h"
+#include "internal/mem_section.h"
 
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <malloc.h>
 
 
 void testPerf(){
@@ -69,6 +81,598 @@ void testPerf(){
     free(buf);
  }
 
+void testBulkPerf(int desc_count, bool test_single){
+    struct timeval start_time, end_time, diff_time;
+    std::vector<nixlBasicDesc> new_descs;
+    std::vector<int> indices;
+
+    // Reverse order is the worst case for sorted addDesc
+    for(int i = desc_count; i>0; i--)
+        new_descs.push_back(nixlBasicDesc((uintptr_t) i*256, 256, 0));
+    for(int i = 0; i<desc_count; i+=2)
+        indices.push_back(i);
+
+    nixl_xfer_dlist_t dlist1 (DRAM_SEG, true, true);
+    nixl_xfer_dlist_t dlist2 (DRAM_SEG, true, true);
+
+    if (test_single) {
+        gettimeofday(&start_time, NULL);
+        for(auto & elm : new_descs)
+            dlist1.addDesc(elm);
+        gettimeofday(&end_time, NULL);
+
+        timersub(&end_time, &start_time, &diff_time);
+        std::cout << "sorted addDesc, total time for " << desc_count << " descs: "
+                  << diff_time.tv_sec << "s " << diff_time.tv_usec << "us \n";
+    }
+
+    gettimeofday(&start_time, NULL);
+    dlist2.addDescs(new_descs);
+    gettimeofday(&end_time, NULL);
+
+    timersub(&end_time, &start_time, &diff_time);
+    std::cout << "sorted addDescs, total time for " << desc_count << " descs: "
+              << diff_time.tv_sec << "s " << diff_time.tv_usec << "us \n";
+
+    assert(dlist2.descCount() == desc_count);
+    assert(dlist2.verifySorted());
+    if (test_single)
+        assert(dlist1 == dlist2);
+
+    if (test_single) {
+        // Removing from the back keeps the indices valid for the single version
+        gettimeofday(&start_time, NULL);
+        for(auto itr = indices.rbegin(); itr != indices.rend(); itr++)
+            dlist1.remDesc(*itr);
+        gettimeofday(&end_time, NULL);
+
+        timersub(&end_time, &start_time, &diff_time);
+        std::cout << "remDesc, total time for " << indices.size() << " descs: "
+                  << diff_time.tv_sec << "s " << diff_time.tv_usec << "us \n";
+    }
+
+    gettimeofday(&start_time, NULL);
+    assert(dlist2.remDescs(indices) == NIXL_SUCCESS);
+    gettimeofday(&end_time, NULL);
+
+    timersub(&end_time, &start_time, &diff_time);
+    std::cout << "remDescs, total time for " << indices.size() << " descs: "
+              << diff_time.tv_sec << "s " << diff_time.tv_usec << "us \n";
+
+    assert(dlist2.descCount() == desc_count - (int) indices.size());
+    assert(dlist2.verifySorted());
+    if (test_single)
+        assert(dlist1 == dlist2);
+}
+
+static float reportRate(const char* name, int desc_count, int iters,
+                        struct timeval &start_time, struct timeval &end_time){
+    struct timeval diff_time;
+    timersub(&end_time, &start_time, &diff_time);
+    float total_us = (diff_time.tv_sec * 1000000) + diff_time.tv_usec;
+    float rate = ((float) desc_count * iters) / total_us;
+    std::cout << name << ", " << iters << " rounds of " << desc_count
+              << " descs: " << total_us << "us, " << rate << " Mdescs/s\n";
+    return total_us;
+}
+
+// Same per descriptor work as postXfer of UCX backend, minus the posting
+void testPostLoopPerf(int desc_count, int iters){
+    struct timeval start_time, end_time;
+    nixl_meta_dlist_t local (DRAM_SEG, true, false, desc_count);
+    nixl_meta_dlist_t remote (DRAM_SEG, true, false, desc_count);
+    volatile uintptr_t sink = 0;
+    uintptr_t acc;
+
+    for(int i = 0; i<desc_count; i++) {
+        local[i]  = nixlMetaDesc(0x1000 + i*256, 256, 0);
+        remote[i] = nixlMetaDesc(0x9000 + i*256, 256, 0);
+        local[i].metadataP  = (nixlBackendMD*) (uintptr_t) (i+1);
+        remote[i].metadataP = (nixlBackendMD*) (uintptr_t) (i+2);
+    }
+
+    gettimeofday(&start_time, NULL);
+    for(int it = 0; it<iters; it++) {
+        acc = 0;
+        for(int i = 0; i<desc_count; i++) {
+            if (local[i].len != remote[i].len)
+                break;
+            acc += local[i].addr ^ remote[i].addr ^
+                   (uintptr_t) local[i].metadataP ^
+                   (uintptr_t) remote[i].metadataP;
+        }
+        sink += acc;
+    }
+    gettimeofday(&end_time, NULL);
+    float checked_us = reportRate("Post loop, checked []", desc_count, iters,
+                                  start_time, end_time);
+    uintptr_t checked_acc = acc;
+
+    gettimeofday(&start_time, NULL);
+    for(int it = 0; it<iters; it++) {
+        const nixlMetaDesc *ldesc = local.data();
+        const nixlMetaDesc *rdesc = remote.data();
+        acc = 0;
+        for(int i = 0; i<desc_count; i++) {
+            if (ldesc[i].len != rdesc[i].len)
+                break;
+            acc += ldesc[i].addr ^ rdesc[i].addr ^
+                   (uintptr_t) ldesc[i].metadataP ^
+                   (uintptr_t) rdesc[i].metadataP;
+        }
+        sink += acc;
+    }
+    gettimeofday(&end_time, NULL);
+    float unchecked_us = reportRate("Post loop, unchecked", desc_count, iters,
+                                    start_time, end_time);
+
+    assert(acc == checked_acc);
+    assert(local.descAt(desc_count-1) == local[desc_count-1]);
+    std::cout << "per desc post loop cost: "
+              << (checked_us * 1000) / ((float) desc_count * iters) << "ns vs "
+              << (unchecked_us * 1000) / ((float) desc_count * iters) << "ns\n";
+    (void) sink;
+}
+
+static long currentRssKB(){
+    long pages = 0, rss = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> rss;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Each load runs in a child process, so the peak RSS is measured separately
+static void runLoad(const char* name, const std::string &path, bool use_mmap,
+                    int desc_count){
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        struct timeval start_time, end_time, diff_time;
+        struct rusage usage;
+        long base_rss = currentRssKB();
+        int n;
+
+        gettimeofday(&start_time, NULL);
+        if (use_mmap) {
+            int fd = open(path.c_str(), O_RDONLY);
+            struct stat st;
+            fstat(fd, &st);
+            void* buf = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            nixlSerDes sd;
+            assert(sd.importView(buf, st.st_size) == NIXL_SUCCESS);
+            nixl_xfer_dlist_t dlist (&sd);
+            munmap(buf, st.st_size);
+            n = dlist.descCount();
+            gettimeofday(&end_time, NULL);
+            getrusage(RUSAGE_SELF, &usage);
+        } else {
+            // What loading a std::string blob used to cost: file content,
+            // the copy in importStr, and the copy from getStr
+            std::ifstream file(path, std::ios::binary);
+            std::stringstream content;
+            content << file.rdbuf();
+            std::string blob = content.str();
+            nixlSerDes sd;
+            assert(sd.importStr(blob) == NIXL_SUCCESS);
+            nixl_mem_t type;
+            bool unified, sorted;
+            size_t n_desc;
+            assert(sd.getStr("nixlDList") == "nixlBDList");
+            sd.getBuf("t", &type, sizeof(type));
+            sd.getBuf("u", &unified, sizeof(unified));
+            sd.getBuf("s", &sorted, sizeof(sorted));
+            sd.getBuf("n", &n_desc, sizeof(n_desc));
+            std::string str = sd.getStr("");
+            nixl_xfer_dlist_t dlist (type, unified, sorted, n_desc);
+            memcpy((void*) &dlist[0], str.data(), str.size());
+            n = dlist.descCount();
+            gettimeofday(&end_time, NULL);
+            getrusage(RUSAGE_SELF, &usage);
+        }
+
+        timersub(&end_time, &start_time, &diff_time);
+        std::cout << name << ", " << n << " descs: " << diff_time.tv_sec
+                  << "s " << diff_time.tv_usec << "us, peak RSS growth "
+                  << (usage.ru_maxrss - base_rss) / 1024 << "MB\n";
+        std::cout.flush();
+        _exit(n == desc_count ? 0 : 1);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+}
+
+void testLoadPerf(int desc_count){
+    std::string path = "/tmp/nixl_desc_example_md." + std::to_string(getpid());
+    nixl_xfer_dlist_t dlist (DRAM_SEG, true, false, desc_count);
+
+    for(int i = 0; i<desc_count; i++)
+        dlist[i] = nixlBasicDesc(0x1000 + i*256, 256, 0);
+
+    {
+        nixlSerDes sd;
+        assert(dlist.serialize(&sd) == NIXL_SUCCESS);
+        std::ofstream file(path, std::ios::binary);
+        std::string blob = sd.exportStr();
+        file.write(blob.data(), blob.size());
+        std::cout << "metadata blob size " << blob.size() / (1024*1024) << "MB\n";
+    }
+
+    // Correctness of the view based loading
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat st;
+        fstat(fd, &st);
+        void* buf = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        nixlSerDes sd;
+        assert(sd.importView(buf, st.st_size) == NIXL_SUCCESS);
+        nixl_xfer_dlist_t loaded (&sd);
+        assert(loaded == dlist);
+        // Truncated views should fail cleanly
+        nixlSerDes sd2;
+        assert(sd2.importView(buf, st.st_size / 2) == NIXL_SUCCESS);
+        nixl_xfer_dlist_t truncated (&sd2);
+        assert(truncated.descCount() == 0);
+        munmap(buf, st.st_size);
+    }
+
+    runLoad("string load", path, false, desc_count);
+    runLoad("mmap view load", path, true, desc_count);
+    unlink(path.c_str());
+}
+
+static float elapsedUs(struct timeval &start_time, struct timeval &end_time){
+    struct timeval diff_time;
+    timersub(&end_time, &start_time, &diff_time);
+    return (diff_time.tv_sec * 1000000) + diff_time.tv_usec;
+}
+
+// Times serialize + export and import + deserialize, returns blob size
+static size_t measureSerDes(const nixl_reg_dlist_t &dlist, bool compress,
+                            int iters){
+    struct timeval start_time, end_time;
+    std::string blob;
+    float encode_us, decode_us;
+
+    gettimeofday(&start_time, NULL);
+    for(int it = 0; it<iters; it++) {
+        nixlSerDes sd(compress);
+        assert(dlist.serialize(&sd) == NIXL_SUCCESS);
+        blob = sd.exportStr();
+    }
+    gettimeofday(&end_time, NULL);
+    encode_us = elapsedUs(start_time, end_time) / iters;
+
+    gettimeofday(&start_time, NULL);
+    for(int it = 0; it<iters; it++) {
+        nixlSerDes sd;
+        assert(sd.importView(blob.data(), blob.size()) == NIXL_SUCCESS);
+        assert(sd.descCompression() == compress);
+        nixl_reg_dlist_t loaded (&sd);
+        assert(loaded == dlist);
+    }
+    gettimeofday(&end_time, NULL);
+    decode_us = elapsedUs(start_time, end_time) / iters;
+
+    std::cout << (compress ? "compressed" : "plain") << " section of "
+              << dlist.descCount() << " descs: " << blob.size() << " bytes, encode "
+              << encode_us << "us (" << dlist.descCount() / encode_us
+              << " Mdescs/s), decode " << decode_us << "us ("
+              << dlist.descCount() / decode_us << " Mdescs/s)\n";
+    return blob.size();
+}
+
+void testCompressPerf(int desc_count){
+    nixl_reg_dlist_t dlist (VRAM_SEG, false, false);
+    int regions = 8, per_region = desc_count / regions;
+    size_t block_size = 64*1024;
+    uint64_t rnd = 0x2545F4914F6CDD1DULL;
+
+    // Looks like UCX rkeys of KV cache blocks: a header, transport info
+    // that is fixed per region, and block address and key that vary.
+    for(int r = 0; r<regions; r++) {
+        uintptr_t base = 0x7f0000000000ULL + ((uintptr_t) r << 36);
+        std::string region_info (40, (char) ('a' + r));
+        for(int i = 0; i<per_region; i++) {
+            uintptr_t addr = base + i*block_size;
+            rnd ^= rnd << 13; rnd ^= rnd >> 7; rnd ^= rnd << 17;
+            std::string meta ("\x01\x00\x07\x00ucx-rkey-v1", 16);
+            meta.append(region_info);
+            meta.append(reinterpret_cast<const char*>(&addr), sizeof(addr));
+            meta.append(reinterpret_cast<const char*>(&rnd), sizeof(rnd));
+            dlist.addDesc(nixlStringDesc(addr, block_size, r, meta));
+        }
+    }
+
+    size_t plain_size = measureSerDes(dlist, false, 10);
+    size_t comp_size  = measureSerDes(dlist, true, 10);
+    std::cout << "compression ratio " << (float) plain_size / comp_size << "\n";
+    assert(comp_size < plain_size);
+
+    // Basic descriptor lists, and irregular values including going backwards
+    nixl_xfer_dlist_t blist = dlist.trim();
+    blist.addDesc(nixlBasicDesc(0x10, 1, 0));
+    blist.addDesc(nixlBasicDesc(UINTPTR_MAX - 5, 5, UINT32_MAX));
+    nixlSerDes sd(true);
+    assert(blist.serialize(&sd) == NIXL_SUCCESS);
+    std::string blob = sd.exportStr();
+    assert(blob.compare(0, 12, "nixlSerDesC|") == 0);
+    nixlSerDes sd2;
+    assert(sd2.importStr(blob) == NIXL_SUCCESS);
+    nixl_xfer_dlist_t bloaded (&sd2);
+    assert(bloaded == blist);
+
+    // Corrupted encoding is rejected, overlong varints at the end
+    nixlSerDes sd3(true);
+    assert(dlist.serialize(&sd3) == NIXL_SUCCESS);
+    blob = sd3.exportStr();
+    blob.replace(blob.size()-31, 30, 30, (char) 0xff);
+    nixlSerDes sd4;
+    assert(sd4.importStr(blob) == NIXL_SUCCESS);
+    nixl_reg_dlist_t bad (&sd4);
+    assert(bad.descCount() == 0);
+
+    // A count the encoding can't hold is rejected before allocating for it
+    nixlSerDes sd5(true);
+    nixl_mem_t mem_type = DRAM_SEG;
+    bool flag = true;
+    size_t huge_count = SIZE_MAX / 4;
+    assert(sd5.addStr("nixlDList", "nixlBDList") == NIXL_SUCCESS);
+    assert(sd5.addBuf("t", &mem_type, sizeof(mem_type)) == NIXL_SUCCESS);
+    assert(sd5.addBuf("u", &flag, sizeof(flag)) == NIXL_SUCCESS);
+    assert(sd5.addBuf("s", &flag, sizeof(flag)) == NIXL_SUCCESS);
+    assert(sd5.addBuf("n", &huge_count, sizeof(huge_count)) == NIXL_SUCCESS);
+    assert(sd5.addStr("", std::string(3, '\0')) == NIXL_SUCCESS);
+    nixlSerDes sd6;
+    assert(sd6.importStr(sd5.exportStr()) == NIXL_SUCCESS);
+    nixl_xfer_dlist_t huge (&sd6);
+    assert(huge.descCount() == 0);
+
+    // Same for the plain string list, with a single descriptor following
+    nixlSerDes sd7;
+    assert(sd7.addStr("nixlDList", "nixlSDList") == NIXL_SUCCESS);
+    assert(sd7.addBuf("t", &mem_type, sizeof(mem_type)) == NIXL_SUCCESS);
+    assert(sd7.addBuf("u", &flag, sizeof(flag)) == NIXL_SUCCESS);
+    assert(sd7.addBuf("s", &flag, sizeof(flag)) == NIXL_SUCCESS);
+    assert(sd7.addBuf("n", &huge_count, sizeof(huge_count)) == NIXL_SUCCESS);
+    assert(sd7.addStr("", nixlStringDesc(0x1000, 64, 0, "rkey").serialize()) == NIXL_SUCCESS);
+    nixlSerDes sd8;
+    assert(sd8.importStr(sd7.exportStr()) == NIXL_SUCCESS);
+    nixl_reg_dlist_t huge_str (&sd8);
+    assert(huge_str.descCount() == 0);
+}
+
+// Stands in for a network backend: loading remote metadata allocates and
+// fills an object of the size of an unpacked rkey, and the count is tracked
+class mockRkeyMD : public nixlBackendMD {
+    public:
+        char rkey[512];
+        mockRkeyMD() : nixlBackendMD(false) {}
+};
+
+class mockRkeyEngine : public nixlBackendEngine {
+    public:
+        int loaded = 0;
+
+        mockRkeyEngine(const nixlBackendInitParams* init_params)
+            : nixlBackendEngine(init_params) {}
+
+        bool supportsRemote () const { return true; }
+        bool supportsLocal () const { return false; }
+        bool supportsNotif () const { return false; }
+        bool supportsProgTh () const { return false; }
+
+        nixl_status_t registerMem (const nixlStringDesc &mem,
+                                   const nixl_mem_t &nixl_mem,
+                                   nixlBackendMD* &out) { return NIXL_ERR_BACKEND; }
+        void deregisterMem (nixlBackendMD* meta) {}
+        nixl_status_t connect(const std::string &remote_agent) { return NIXL_SUCCESS; }
+        nixl_status_t disconnect(const std::string &remote_agent) { return NIXL_SUCCESS; }
+
+        nixl_status_t loadRemoteMD (const nixlStringDesc &input,
+                                    const nixl_mem_t &nixl_mem,
+                                    const std::string &remote_agent,
+                                    nixlBackendMD* &output) {
+            mockRkeyMD* md = new mockRkeyMD();
+            memset(md->rkey, 0, sizeof(md->rkey));
+            memcpy(md->rkey, input.metaInfo.data(),
+                   std::min(input.metaInfo.size(), sizeof(md->rkey)));
+            output = md;
+            loaded++;
+            return NIXL_SUCCESS;
+        }
+        nixl_status_t unloadMD (nixlBackendMD* input) {
+            delete (mockRkeyMD*) input;
+            loaded--;
+            return NIXL_SUCCESS;
+        }
+
+        nixl_status_t postXfer (const nixl_meta_dlist_t &local,
+                                const nixl_meta_dlist_t &remote,
+                                const nixl_xfer_op_t &operation,
+                                const std::string &remote_agent,
+                                const std::string &notif_msg,
+                                nixlBackendReqH* &handle) { return NIXL_ERR_BACKEND; }
+        nixl_status_t checkXfer(nixlBackendReqH* handle) { return NIXL_ERR_BACKEND; }
+        void releaseReqH(nixlBackendReqH* handle) {}
+};
+
+// Each run loads a remote section in a child process and populates used_count
+// of its descriptors, all of them is what loading everything up front costs
+static void runSectionLoad(const std::string &blob, int desc_count,
+                           int used_count){
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        struct timeval start_time, end_time;
+        nixl_b_params_t params;
+        nixlBackendInitParams init_params;
+        init_params.localAgent   = "Agent1";
+        init_params.type         = "MOCK";
+        init_params.customParams = &params;
+        mockRkeyEngine engine(&init_params);
+        backend_map_t engine_map;
+        engine_map["MOCK"] = &engine;
+
+        nixl_xfer_dlist_t query (DRAM_SEG, true, true);
+        nixl_meta_dlist_t resp (DRAM_SEG, true, true);
+        int stride = desc_count / used_count;
+        for(int i = 0; i<used_count; i++)
+            query.addDesc(nixlBasicDesc(0x1000 + i*stride*256 + 64, 128, 0));
+
+        malloc_trim(0);
+        long base_rss = currentRssKB();
+        gettimeofday(&start_time, NULL);
+        nixlRemoteSection* section = new nixlRemoteSection("Agent2", engine_map);
+        nixlSerDes sd;
+        assert(sd.importView(blob.data(), blob.size()) == NIXL_SUCCESS);
+        assert(section->loadRemoteData(&sd) == NIXL_SUCCESS);
+        assert(section->populate(query, "MOCK", resp) == NIXL_SUCCESS);
+        gettimeofday(&end_time, NULL);
+        malloc_trim(0); // Only count what is kept after the load
+        long rss = currentRssKB() - base_rss;
+
+        assert(engine.loaded == used_count);
+        for(auto & elm : resp) {
+            assert(elm.metadataP != nullptr);
+            assert(((mockRkeyMD*) elm.metadataP)->rkey[0] == 'R');
+        }
+        // Cached, a second populate does not load again
+        nixlBackendMD* first = resp.descAt(0).metadataP;
+        assert(section->populate(query, "MOCK", resp) == NIXL_SUCCESS);
+        assert(engine.loaded == used_count);
+        assert(resp.descAt(0).metadataP == first);
+
+        std::cout << "remote section of " << desc_count << " descs, "
+                  << used_count << " used: " << elapsedUs(start_time, end_time) / 1000
+                  << "ms, RSS growth " << rss / 1024 << "MB\n";
+        std::cout.flush();
+
+        delete section;
+        _exit(engine.loaded == 0 ? 0 : 1);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+}
+
+void testRemoteSectionPerf(int desc_count, int used_count){
+    nixl_reg_dlist_t dlist (DRAM_SEG, true, false);
+    std::string rkey(100, 'R'); // Around the size of a packed UCX rkey
+
+    for(int i = 0; i<desc_count; i++) {
+        memcpy(&rkey[1], &i, sizeof(i));
+        dlist.addDesc(nixlStringDesc(0x1000 + i*256, 256, 0, rkey));
+    }
+
+    // Same layout as nixlLocalSection::serialize with a single backend
+    nixlSerDes sd;
+    size_t seg_count = 1;
+    assert(sd.addBuf("nixlSecElms", &seg_count, sizeof(seg_count)) == NIXL_SUCCESS);
+    assert(sd.addStr("bknd", "MOCK") == NIXL_SUCCESS);
+    assert(dlist.serialize(&sd) == NIXL_SUCCESS);
+    std::string blob = sd.exportStr();
+
+    runSectionLoad(blob, desc_count, used_count);
+    runSectionLoad(blob, desc_count, desc_count);
+}
+
+// Slice of one head from a [layers, tokens, heads, dim] tensor, with each
+// layer registered separately: one strided descriptor per layer, against one
+// descriptor per token and layer in the flattened form.
+void testStridedPerf(int layers, int tokens, int heads, int iters){
+    size_t elem_len = 256; // dim of 128 in 16 bits
+    size_t layer_len = (size_t) tokens * heads * elem_len;
+    uintptr_t base = 0x100000;
+    struct timeval start_time, end_time;
+
+    nixl_b_params_t params;
+    nixlBackendInitParams init_params;
+    init_params.localAgent   = "Agent1";
+    init_params.type         = "MOCK";
+    init_params.customParams = &params;
+    mockRkeyEngine engine(&init_params);
+    backend_map_t engine_map;
+    engine_map["MOCK"] = &engine;
+
+    nixl_reg_dlist_t dlist (DRAM_SEG, true, false);
+    for(int l = 0; l<layers; l++)
+        dlist.addDesc(nixlStringDesc(base + l*layer_len, layer_len, 0, "RKEY"));
+
+    nixlSerDes sd;
+    size_t seg_count = 1;
+    assert(sd.addBuf("nixlSecElms", &seg_count, sizeof(seg_count)) == NIXL_SUCCESS);
+    assert(sd.addStr("bknd", "MOCK") == NIXL_SUCCESS);
+    assert(dlist.serialize(&sd) == NIXL_SUCCESS);
+    nixlRemoteSection section("Agent2", engine_map);
+    assert(section.loadRemoteData(&sd) == NIXL_SUCCESS);
+
+    nixl_meta_dlist_t flat_resp (DRAM_SEG, true, true);
+    nixl_meta_dlist_t strided_resp (DRAM_SEG, true, false);
+    int head = 3;
+
+    gettimeofday(&start_time, NULL);
+    for(int i = 0; i<iters; i++) {
+        nixl_xfer_dlist_t flat (DRAM_SEG, true, true);
+        std::vector<nixlBasicDesc> elems;
+        elems.reserve(layers * tokens);
+        for(int l = 0; l<layers; l++)
+            for(int t = 0; t<tokens; t++)
+                elems.push_back(nixlBasicDesc(base + l*layer_len +
+                                    (t*heads + head)*elem_len, elem_len, 0));
+        flat.addDescs(elems);
+        assert(section.populate(flat, "MOCK", flat_resp) == NIXL_SUCCESS);
+    }
+    gettimeofday(&end_time, NULL);
+    float flat_us = reportRate("Flattened populate", layers*tokens, iters,
+                               start_time, end_time);
+
+    gettimeofday(&start_time, NULL);
+    for(int i = 0; i<iters; i++) {
+        nixl_strided_dlist_t strided (DRAM_SEG, true, false);
+        for(int l = 0; l<layers; l++)
+            strided.addDesc(nixlStridedDesc(base + l*layer_len + head*elem_len,
+                                            elem_len, heads*elem_len, tokens, 0));
+        assert(section.populate(strided, "MOCK", strided_resp) == NIXL_SUCCESS);
+    }
+    gettimeofday(&end_time, NULL);
+    float strided_us = reportRate("Strided populate", layers*tokens, iters,
+                                  start_time, end_time);
+    std::cout << "strided vs flattened descriptor processing: "
+              << strided_us / flat_us << "x the time\n";
+
+    // Same elements in the same order, with metadata loaded once per layer
+    assert(flat_resp.descCount() == strided_resp.descCount());
+    for(int i = 0; i<flat_resp.descCount(); i++)
+        assert(flat_resp.descAt(i) == strided_resp.descAt(i));
+    assert(engine.loaded == layers);
+
+    // Out of the registered layer, or crossing two layers
+    nixl_strided_dlist_t bad (DRAM_SEG, true, false);
+    bad.addDesc(nixlStridedDesc(base + head*elem_len, elem_len,
+                                heads*elem_len, tokens+1, 0));
+    assert(section.populate(bad, "MOCK", strided_resp) != NIXL_SUCCESS);
+    assert(strided_resp.descCount() == 0);
+
+    // No elements, an extent that wraps, or more elements than a list holds
+    nixlStridedDesc wraps[] = {
+        nixlStridedDesc(base, elem_len, heads*elem_len, 0, 0),
+        nixlStridedDesc(base, elem_len, SIZE_MAX/2, 3, 0),
+        nixlStridedDesc(base, elem_len, 0, (size_t) INT_MAX + 1, 0) };
+    for (auto &w : wraps) {
+        nixl_strided_dlist_t overflow (DRAM_SEG, true, false);
+        overflow.addDesc(w);
+        assert(section.populate(overflow, "MOCK", strided_resp) ==
+               NIXL_ERR_INVALID_PARAM);
+        assert(strided_resp.descCount() == 0);
+    }
+    assert(!wraps[0].validExtent() && !wraps[1].validExtent());
+}
+
 int main()
 {
     // nixlBasicDesc functionality
@@ -90,6 +694,17 @@ int main()
     nixlBasicDesc importDesc(buff2.serialize());
     assert(buff2 == importDesc);
 
+    // nixlStridedDesc functionality
+    nixlStridedDesc sbuff1 (1000, 10, 100, 5, 0);
+    nixlStridedDesc sbuff2 (buff1);
+    nixlStridedDesc sbuff3 (sbuff1.serialize());
+    assert (sbuff1.validExtent());
+    assert (sbuff1.extent() == nixlBasicDesc(1000, 410, 0));
+    assert (!sbuff1.isContiguous());
+    assert (sbuff2.isContiguous() && sbuff2.extent() == buff1);
+    assert (sbuff3 == sbuff1);
+    assert (sbuff3 != sbuff2);
+
     assert (buff3==buff2);
     assert (buff4==buff1);
     assert (buff3!=buff1);
@@ -207,6 +822,25 @@ int main()
     dlist2.print();
     dlist3.print();
 
+    // Bulk add and remove
+    nixl_meta_dlist_t dlist6 (DRAM_SEG, true, true);
+    nixl_meta_dlist_t dlist7 (DRAM_SEG, true, true);
+    std::vector<nixlMetaDesc> bulk = {meta3, meta1, meta4, meta2};
+    for (auto & elm : bulk)
+        dlist6.addDesc(elm);
+    dlist7.addDescs(bulk);
+    assert (dlist6 == dlist7);
+    dlist7.addDescs(dlist4);
+    assert (dlist7.descCount() == 6);
+    assert (dlist7.verifySorted());
+
+    assert (dlist7.remDescs({0, 6}) == NIXL_ERR_INVALID_PARAM);
+    assert (dlist7.descCount() == 6);
+    assert (dlist7.remDescs({5, 0, 0, 2}) == NIXL_SUCCESS);
+    assert (dlist7.descCount() == 3);
+    assert (dlist7.verifySorted());
+    assert (dlist7.getIndex(meta2) == NIXL_ERR_NOT_FOUND);
+
     // Populate and unifiedAddr test
     std::cout << "\n\n";
     nixlStringDesc s1 (10070, 43, 0);
@@ -309,6 +943,13 @@ int main()
     dlist25.print();
 
     testPerf();
+    testBulkPerf(100000, true);
+    testBulkPerf(1000000, false);
+    testPostLoopPerf(10000, 1000);
+    testLoadPerf(4*1024*1024);
+    testCompressPerf(100000);
+    testRemoteSectionPerf(100000, 1000);
+    testStridedPerf(32, 4096, 8, 20);
 
     delete ser_des;
     delete ser_des2;
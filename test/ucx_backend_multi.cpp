@@ -63,9 +63,16 @@ void test_thread(int id)
     ret = ucx->loadRemoteConnInfo(other, conn_info[!id]);
     assert(ret == NIXL_SUCCESS);
 
-    //one-sided connect
-    if(!id)
+    //one-sided connect, non-blocking version
+    if(!id) {
+        ret = ucx->connectAsync(other);
+        while(ret == NIXL_IN_PROG)
+            ret = ucx->checkConnect(other);
+        assert(ret == NIXL_SUCCESS);
+
+        //already connected, blocking version returns right away
         ret = ucx->connect(other);
+    }
 
     assert(ret == NIXL_SUCCESS);
 
@@ -41,12 +41,16 @@ static void checkCudaError(cudaError_t result, const char *message) {
 
 
 
-nixlBackendEngine *createEngine(std::string name, bool p_thread)
+nixlBackendEngine *createEngine(std::string name, bool p_thread, bool lazy = false)
 {
     nixlBackendEngine     *ucx;
     nixlBackendInitParams init;
     nixl_b_params_t       custom_params;
 
+    if (lazy) {
+        custom_params["lazy_connect"] = "true";
+    }
+
     init.enableProgTh = p_thread;
     init.pthrDelay    = 100;
     init.localAgent   = name;
@@ -604,6 +608,16 @@ int main()
 #endif
     }
 
+    // Endpoint and rkeys are created by the first transfer
+    nixlBackendEngine *lazy_ucx[2];
+    lazy_ucx[0] = createEngine("Agent1", false, true);
+    lazy_ucx[1] = createEngine("Agent2", false, true);
+    test_inter_agent_transfer(false,
+                              lazy_ucx[0], DRAM_SEG, 0,
+                              lazy_ucx[1], DRAM_SEG, 0);
+    releaseEngine(lazy_ucx[0]);
+    releaseEngine(lazy_ucx[1]);
+
     // Allocate UCX engines
     for(int i = 0; i < 2; i++) {
         for(int j = 0; j < 2; j++) {
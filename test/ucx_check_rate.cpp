@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Posts transfers with many outstanding ops per handle on the UCX engine,
+// one per descriptor, and measures the cost of posting and of each
+// checkXfer poll until completion, over loopback in the same process.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+#include <sys/time.h>
+
+#include "ucx_backend.h"
+
+#define FRAG_SIZE 4096
+
+std::string agent1("Agent1");
+std::string agent2("Agent2");
+
+nixlBackendEngine *createEngine(std::string name)
+{
+    nixlBackendEngine     *ucx;
+    nixlBackendInitParams init;
+    nixl_b_params_t       custom_params;
+
+    // Keep one op per descriptor
+    custom_params["iov_gather"] = "false";
+
+    init.enableProgTh = false;
+    init.pthrDelay    = 100;
+    init.localAgent   = name;
+    init.customParams = &custom_params;
+    init.type         = "UCX";
+
+    ucx = (nixlBackendEngine*) new nixlUcxEngine (&init);
+    if (ucx->getInitErr()) {
+        std::cout << "Failed to initialize " << name << std::endl;
+        exit(1);
+    }
+    return ucx;
+}
+
+static double elapsedUs(struct timeval &start_time, struct timeval &end_time)
+{
+    struct timeval diff_time;
+    timersub(&end_time, &start_time, &diff_time);
+    return (diff_time.tv_sec * 1000000.0) + diff_time.tv_usec;
+}
+
+void runChecks(nixlBackendEngine *ucx1, nixlBackendEngine *ucx2,
+               nixl_meta_dlist_t &src_descs, nixl_meta_dlist_t &dst_descs,
+               int iters)
+{
+    struct timeval start_time, post_time, end_time;
+    double post_us = 0, check_us = 0;
+    long checks = 0;
+
+    for (int i = 0; i < iters; i++) {
+        nixlBackendReqH* handle;
+
+        gettimeofday(&start_time, NULL);
+        nixl_status_t ret = ucx1->postXfer(src_descs, dst_descs, NIXL_WRITE,
+                                           agent2, "", handle);
+        gettimeofday(&post_time, NULL);
+        assert(ret == NIXL_SUCCESS || ret == NIXL_IN_PROG);
+
+        while (ret == NIXL_IN_PROG) {
+            ucx2->progress();
+            ret = ucx1->checkXfer(handle);
+            checks++;
+        }
+        gettimeofday(&end_time, NULL);
+        assert(ret == NIXL_SUCCESS);
+        if (handle)
+            ucx1->releaseReqH(handle);
+
+        post_us  += elapsedUs(start_time, post_time);
+        check_us += elapsedUs(post_time, end_time);
+    }
+
+    std::cout << src_descs.descCount() << " ops per handle: post "
+              << post_us / iters << "us, " << (double) checks / iters
+              << " checks per transfer, " << (checks ? check_us * 1000 / checks : 0)
+              << "ns per check" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> op_counts = {100, 1000, 10000};
+    int iters = 100;
+
+    // ucx_check_rate [ops per handle] [iterations]
+    if (argc > 1)
+        op_counts = {atoi(argv[1])};
+    if (argc > 2)
+        iters = atoi(argv[2]);
+    assert(op_counts[0] > 0 && iters > 0);
+
+    nixlBackendEngine *ucx1 = createEngine(agent1);
+    nixlBackendEngine *ucx2 = createEngine(agent2);
+    assert(ucx1->loadRemoteConnInfo(agent2, ucx2->getConnInfo()) == NIXL_SUCCESS);
+
+    for (auto & count : op_counts) {
+        size_t len = (size_t) count * FRAG_SIZE;
+        char *src_buf = (char*) calloc(1, len);
+        char *dst_buf = (char*) calloc(1, len);
+        nixlBackendMD *src_md, *dst_md, *rmd;
+
+        nixlStringDesc src_reg((uintptr_t) src_buf, len, 0, "");
+        nixlStringDesc dst_reg((uintptr_t) dst_buf, len, 0, "");
+        assert(ucx1->registerMem(src_reg, DRAM_SEG, src_md) == NIXL_SUCCESS);
+        assert(ucx2->registerMem(dst_reg, DRAM_SEG, dst_md) == NIXL_SUCCESS);
+        dst_reg.metaInfo = ucx2->getPublicData(dst_md);
+        assert(ucx1->loadRemoteMD(dst_reg, DRAM_SEG, agent2, rmd) == NIXL_SUCCESS);
+
+        // Reversed on the remote side, so no two descriptors are merged
+        nixl_meta_dlist_t src_descs(DRAM_SEG), dst_descs(DRAM_SEG);
+        for (int i = 0; i < count; i++) {
+            nixlMetaDesc src, dst;
+            src.addr      = (uintptr_t) (src_buf + (size_t) i * FRAG_SIZE);
+            src.len       = FRAG_SIZE;
+            src.devId     = 0;
+            src.metadataP = src_md;
+            dst.addr      = (uintptr_t) (dst_buf + (size_t) (count - 1 - i) * FRAG_SIZE);
+            dst.len       = FRAG_SIZE;
+            dst.devId     = 0;
+            dst.metadataP = rmd;
+            src_descs.addDesc(src);
+            dst_descs.addDesc(dst);
+        }
+
+        runChecks(ucx1, ucx2, src_descs, dst_descs, iters);
+
+        assert(ucx1->unloadMD(rmd) == NIXL_SUCCESS);
+        ucx1->deregisterMem(src_md);
+        ucx2->deregisterMem(dst_md);
+        free(src_buf);
+        free(dst_buf);
+    }
+
+    assert(ucx1->disconnect(agent2) == NIXL_SUCCESS);
+    delete ucx1;
+    delete ucx2;
+
+    return 0;
+}
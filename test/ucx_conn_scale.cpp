@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Loads connection info and metadata of many simulated remote agents into one
+// UCX engine, to see how load time and memory scale with the number of peers.
+// A few real engines in the same process serve as the peers over loopback,
+// and each simulated agent reuses the connection info of one of them.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+#include <unistd.h>
+#include <malloc.h>
+#include <sys/time.h>
+
+#include "ucx_backend.h"
+
+#define NUM_REAL_PEERS 4
+#define BLOCK_SIZE     4096
+
+struct peerData {
+    nixlBackendEngine*          engine;
+    std::string                 connInfo;
+    std::vector<void*>          buffers;
+    std::vector<nixlBackendMD*> localMD;
+    nixl_reg_dlist_t            remoteDescs;
+
+    peerData() : remoteDescs(DRAM_SEG, false, false) {}
+};
+
+nixlBackendEngine *createEngine(std::string name, bool lazy, size_t num_eps)
+{
+    nixlBackendEngine     *ucx;
+    nixlBackendInitParams init;
+    nixl_b_params_t       custom_params;
+
+    if (lazy)
+        custom_params["lazy_connect"] = "true";
+    custom_params["num_eps"] = std::to_string(num_eps);
+
+    init.enableProgTh = false;
+    init.pthrDelay    = 100;
+    init.localAgent   = name;
+    init.customParams = &custom_params;
+    init.type         = "UCX";
+
+    ucx = (nixlBackendEngine*) new nixlUcxEngine (&init);
+    if (ucx->getInitErr()) {
+        std::cout << "Failed to initialize " << name << std::endl;
+        exit(1);
+    }
+    return ucx;
+}
+
+static long currentRssKB()
+{
+    long pages = 0, rss = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> rss;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void createPeer(peerData &peer, int id, int num_blocks)
+{
+    std::string name = "Peer" + std::to_string(id);
+    peer.engine = createEngine(name, false, 3);
+    peer.connInfo = peer.engine->getConnInfo();
+
+    for (int i = 0; i < num_blocks; i++) {
+        void* buf = calloc(1, BLOCK_SIZE);
+        nixlStringDesc desc((uintptr_t) buf, BLOCK_SIZE, 0, "");
+        nixlBackendMD* md;
+
+        assert(peer.engine->registerMem(desc, DRAM_SEG, md) == NIXL_SUCCESS);
+        desc.metaInfo = peer.engine->getPublicData(md);
+        peer.buffers.push_back(buf);
+        peer.localMD.push_back(md);
+        peer.remoteDescs.addDesc(desc);
+    }
+}
+
+void destroyPeer(peerData &peer)
+{
+    for (auto & md : peer.localMD)
+        peer.engine->deregisterMem(md);
+    for (auto & buf : peer.buffers)
+        free(buf);
+    delete peer.engine;
+}
+
+void runScale(std::vector<peerData> &peers, int num_agents, bool lazy)
+{
+    struct timeval start_time, end_time, diff_time;
+    std::vector<nixlBackendMD*> loaded;
+    int num_blocks = peers[0].remoteDescs.descCount();
+
+    loaded.reserve((size_t) num_agents * num_blocks);
+
+    nixlBackendEngine* ucx = createEngine("Agent", lazy, num_agents);
+
+    malloc_trim(0);
+    long base_rss = currentRssKB();
+    gettimeofday(&start_time, NULL);
+
+    for (int i = 0; i < num_agents; i++) {
+        std::string name = "Sim" + std::to_string(i);
+        peerData &peer = peers[i % peers.size()];
+        nixlBackendMD* md;
+
+        assert(ucx->loadRemoteConnInfo(name, peer.connInfo) == NIXL_SUCCESS);
+        for (auto & desc : peer.remoteDescs) {
+            assert(ucx->loadRemoteMD(desc, DRAM_SEG, name, md) == NIXL_SUCCESS);
+            loaded.push_back(md);
+        }
+    }
+
+    gettimeofday(&end_time, NULL);
+    malloc_trim(0);
+    long rss = currentRssKB() - base_rss;
+    timersub(&end_time, &start_time, &diff_time);
+
+    std::cout << (lazy ? "lazy " : "eager") << " connect, " << num_agents
+              << " agents x " << num_blocks << " blocks: load "
+              << diff_time.tv_sec * 1000 + diff_time.tv_usec / 1000 << "ms ("
+              << (diff_time.tv_sec * 1000000.0 + diff_time.tv_usec) / num_agents
+              << "us per agent), RSS growth " << rss / 1024 << "MB ("
+              << rss / (double) num_agents << "KB per agent)" << std::endl;
+
+    for (auto & md : loaded)
+        assert(ucx->unloadMD(md) == NIXL_SUCCESS);
+    for (int i = 0; i < num_agents; i++)
+        assert(ucx->disconnect("Sim" + std::to_string(i)) == NIXL_SUCCESS);
+    delete ucx;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> agent_counts = {1000, 10000};
+    int num_blocks = 16;
+
+    // ucx_conn_scale [agent count] [blocks per agent]
+    if (argc > 1)
+        agent_counts = {atoi(argv[1])};
+    if (argc > 2)
+        num_blocks = atoi(argv[2]);
+    assert(agent_counts[0] > 0 && num_blocks > 0);
+
+    std::vector<peerData> peers(NUM_REAL_PEERS);
+    for (int i = 0; i < NUM_REAL_PEERS; i++)
+        createPeer(peers[i], i, num_blocks);
+
+    for (auto & count : agent_counts) {
+        runScale(peers, count, false);
+        runScale(peers, count, true);
+    }
+
+    for (auto & peer : peers)
+        destroyPeer(peer);
+
+    return 0;
+}
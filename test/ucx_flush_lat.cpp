@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Latency of small single-descriptor transfers on the UCX engine with
+// flush_mode "always" and "lazy", and with the data inside the notification
+// (notif_inline), over loopback in the same process. READ and WRITE are timed
+// to completion at the initiator, WR_NOTIF until the target has received the
+// notification.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+#include <sys/time.h>
+
+#include "ucx_backend.h"
+
+std::string agent1("Agent1");
+std::string agent2("Agent2");
+
+nixlBackendEngine *createEngine(std::string name, const std::string &flush_mode,
+                                size_t notif_inline)
+{
+    nixlBackendEngine     *ucx;
+    nixlBackendInitParams init;
+    nixl_b_params_t       custom_params;
+
+    custom_params["flush_mode"]   = flush_mode;
+    custom_params["notif_inline"] = std::to_string(notif_inline);
+
+    init.enableProgTh = false;
+    init.pthrDelay    = 100;
+    init.localAgent   = name;
+    init.customParams = &custom_params;
+    init.type         = "UCX";
+
+    ucx = (nixlBackendEngine*) new nixlUcxEngine (&init);
+    if (ucx->getInitErr()) {
+        std::cout << "Failed to initialize " << name << std::endl;
+        exit(1);
+    }
+    return ucx;
+}
+
+static const char* op2str(nixl_xfer_op_t op)
+{
+    switch (op) {
+    case NIXL_READ:     return "READ    ";
+    case NIXL_WRITE:    return "WRITE   ";
+    case NIXL_WR_NOTIF: return "WR_NOTIF";
+    default:            return "RD_NOTIF";
+    }
+}
+
+double measureLat(nixlBackendEngine *ucx1, nixlBackendEngine *ucx2,
+                  nixl_meta_dlist_t &src, nixl_meta_dlist_t &dst,
+                  nixl_xfer_op_t op, int iters)
+{
+    struct timeval start_time, end_time, diff_time;
+    notif_list_t notifs;
+
+    gettimeofday(&start_time, NULL);
+    for (int i = 0; i < iters; i++) {
+        nixlBackendReqH* handle;
+        nixl_status_t ret = ucx1->postXfer(src, dst, op, agent2, "n", handle);
+        assert(ret == NIXL_SUCCESS || ret == NIXL_IN_PROG);
+
+        while (ret == NIXL_IN_PROG) {
+            ucx2->progress();
+            ret = ucx1->checkXfer(handle);
+        }
+        assert(ret == NIXL_SUCCESS);
+        if (handle)
+            ucx1->releaseReqH(handle);
+
+        if (op == NIXL_WR_NOTIF) {
+            while (ucx2->getNotifs(notifs) == 0)
+                ucx1->progress();
+            notifs.clear();
+        }
+    }
+    gettimeofday(&end_time, NULL);
+    timersub(&end_time, &start_time, &diff_time);
+
+    return (diff_time.tv_sec * 1000000.0 + diff_time.tv_usec) / iters;
+}
+
+void runMode(const std::string &flush_mode, size_t notif_inline,
+             std::vector<size_t> &sizes, int iters)
+{
+    nixlBackendEngine *ucx1 = createEngine(agent1, flush_mode, notif_inline);
+    nixlBackendEngine *ucx2 = createEngine(agent2, flush_mode, notif_inline);
+    size_t max_size = sizes.back();
+    void *src_buf = calloc(1, max_size);
+    void *dst_buf = calloc(1, max_size);
+    nixlBackendMD *src_md, *dst_md, *rmd;
+
+    assert(ucx1->loadRemoteConnInfo(agent2, ucx2->getConnInfo()) == NIXL_SUCCESS);
+
+    nixlStringDesc src_reg((uintptr_t) src_buf, max_size, 0, "");
+    nixlStringDesc dst_reg((uintptr_t) dst_buf, max_size, 0, "");
+    assert(ucx1->registerMem(src_reg, DRAM_SEG, src_md) == NIXL_SUCCESS);
+    assert(ucx2->registerMem(dst_reg, DRAM_SEG, dst_md) == NIXL_SUCCESS);
+    dst_reg.metaInfo = ucx2->getPublicData(dst_md);
+    assert(ucx1->loadRemoteMD(dst_reg, DRAM_SEG, agent2, rmd) == NIXL_SUCCESS);
+
+    for (auto & size : sizes) {
+        nixl_meta_dlist_t src(DRAM_SEG), dst(DRAM_SEG);
+        nixlMetaDesc sdesc, ddesc;
+        sdesc.addr      = (uintptr_t) src_buf;
+        sdesc.len       = size;
+        sdesc.devId     = 0;
+        sdesc.metadataP = src_md;
+        ddesc.addr      = (uintptr_t) dst_buf;
+        ddesc.len       = size;
+        ddesc.devId     = 0;
+        ddesc.metadataP = rmd;
+        src.addDesc(sdesc);
+        dst.addDesc(ddesc);
+
+        for (nixl_xfer_op_t op : {NIXL_READ, NIXL_WRITE, NIXL_WR_NOTIF})
+            std::cout << "flush_mode " << flush_mode << ", notif_inline "
+                      << notif_inline << ", " << op2str(op)
+                      << " " << size << "B: "
+                      << measureLat(ucx1, ucx2, src, dst, op, iters)
+                      << "us" << std::endl;
+    }
+
+    assert(ucx1->unloadMD(rmd) == NIXL_SUCCESS);
+    ucx1->deregisterMem(src_md);
+    ucx2->deregisterMem(dst_md);
+    assert(ucx1->disconnect(agent2) == NIXL_SUCCESS);
+    delete ucx1;
+    delete ucx2;
+    free(src_buf);
+    free(dst_buf);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<size_t> sizes = {8, 64, 512, 4096};
+    int iters = 10000;
+
+    // ucx_flush_lat [iterations]
+    if (argc > 1)
+        iters = atoi(argv[1]);
+    assert(iters > 0);
+
+    runMode("always", 0, sizes, iters);
+    runMode("lazy", 0, sizes, iters);
+    runMode("always", sizes.back(), sizes, iters);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Writes scattered local fragments into one contiguous remote region, as when
+// packing blocks of a paged buffer for a peer. Compares the transfer rate of
+// the UCX engine with the experimental iov_gather (one op per remote region)
+// against one op per descriptor, over loopback between two engines in the
+// same process. Where UCX refuses iov RMA, both fall back to the same ops.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <sys/time.h>
+
+#include "ucx_backend.h"
+
+std::string agent1("Agent1");
+std::string agent2("Agent2");
+
+nixlBackendEngine *createEngine(std::string name, bool iov_gather)
+{
+    nixlBackendEngine     *ucx;
+    nixlBackendInitParams init;
+    nixl_b_params_t       custom_params;
+
+    custom_params["iov_gather"] = iov_gather ? "true" : "false";
+
+    init.enableProgTh = false;
+    init.pthrDelay    = 100;
+    init.localAgent   = name;
+    init.customParams = &custom_params;
+    init.type         = "UCX";
+
+    ucx = (nixlBackendEngine*) new nixlUcxEngine (&init);
+    if (ucx->getInitErr()) {
+        std::cout << "Failed to initialize " << name << std::endl;
+        exit(1);
+    }
+    return ucx;
+}
+
+static nixlBackendMD* registerBuf(nixlBackendEngine *ucx, void *buf, size_t len)
+{
+    nixlStringDesc desc((uintptr_t) buf, len, 0, "");
+    nixlBackendMD* md;
+
+    assert(ucx->registerMem(desc, DRAM_SEG, md) == NIXL_SUCCESS);
+    return md;
+}
+
+void runRate(bool iov_gather, size_t frag_size, int num_frags, int iters)
+{
+    nixlBackendEngine *ucx1 = createEngine(agent1, iov_gather);
+    nixlBackendEngine *ucx2 = createEngine(agent2, iov_gather);
+    struct timeval start_time, end_time, diff_time;
+    size_t len = frag_size * num_frags;
+
+    assert(ucx1->loadRemoteConnInfo(agent2, ucx2->getConnInfo()) == NIXL_SUCCESS);
+
+    // Every other fragment of the source, so no two of them are adjacent
+    char *src_buf = (char*) calloc(2, len);
+    char *dst_buf = (char*) calloc(1, len);
+    nixlBackendMD *src_md = registerBuf(ucx1, src_buf, 2 * len);
+    nixlBackendMD *dst_md = registerBuf(ucx2, dst_buf, len);
+    nixlBackendMD *rmd;
+
+    nixlStringDesc info((uintptr_t) dst_buf, len, 0, ucx2->getPublicData(dst_md));
+    assert(ucx1->loadRemoteMD(info, DRAM_SEG, agent2, rmd) == NIXL_SUCCESS);
+
+    nixl_meta_dlist_t src_descs(DRAM_SEG), dst_descs(DRAM_SEG);
+    for (int i = 0; i < num_frags; i++) {
+        nixlMetaDesc src, dst;
+        src.addr      = (uintptr_t) (src_buf + 2 * i * frag_size);
+        src.len       = frag_size;
+        src.devId     = 0;
+        src.metadataP = src_md;
+        dst.addr      = (uintptr_t) (dst_buf + i * frag_size);
+        dst.len       = frag_size;
+        dst.devId     = 0;
+        dst.metadataP = rmd;
+        src_descs.addDesc(src);
+        dst_descs.addDesc(dst);
+        memset(src_buf + 2 * i * frag_size, i + 1, frag_size);
+    }
+
+    gettimeofday(&start_time, NULL);
+    for (int i = 0; i < iters; i++) {
+        nixlBackendReqH* handle;
+        nixl_status_t ret = ucx1->postXfer(src_descs, dst_descs, NIXL_WRITE,
+                                           agent2, "", handle);
+        assert(ret == NIXL_SUCCESS || ret == NIXL_IN_PROG);
+        if (ret == NIXL_SUCCESS)
+            continue;
+        while (ret == NIXL_IN_PROG) {
+            ucx2->progress();
+            ret = ucx1->checkXfer(handle);
+        }
+        assert(ret == NIXL_SUCCESS);
+        ucx1->releaseReqH(handle);
+    }
+    gettimeofday(&end_time, NULL);
+    timersub(&end_time, &start_time, &diff_time);
+
+    for (int i = 0; i < num_frags; i++)
+        assert(dst_buf[i * frag_size] == (char) (i + 1) &&
+               dst_buf[(i + 1) * frag_size - 1] == (char) (i + 1));
+
+    double us = diff_time.tv_sec * 1000000.0 + diff_time.tv_usec;
+    std::cout << (iov_gather ? "iov gather" : "per desc  ") << ", "
+              << num_frags << " x " << frag_size << "B: "
+              << iters / us * 1000000 << " xfers/s, "
+              << (double) iters * num_frags / us << " Mdescs/s, "
+              << (double) iters * len / us << " MB/s" << std::endl;
+
+    assert(ucx1->unloadMD(rmd) == NIXL_SUCCESS);
+    ucx1->deregisterMem(src_md);
+    ucx2->deregisterMem(dst_md);
+    assert(ucx1->disconnect(agent2) == NIXL_SUCCESS);
+    delete ucx1;
+    delete ucx2;
+    free(src_buf);
+    free(dst_buf);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<size_t> frag_sizes = {64, 256, 1024, 4096};
+    int num_frags = 64;
+    int iters = 10000;
+
+    // ucx_iov_rate [fragments per transfer] [iterations]
+    if (argc > 1)
+        num_frags = atoi(argv[1]);
+    if (argc > 2)
+        iters = atoi(argv[2]);
+    assert(num_frags > 0 && iters > 0);
+
+    for (auto & size : frag_sizes) {
+        runRate(false, size, num_frags, iters);
+        runRate(true, size, num_frags, iters);
+    }
+
+    return 0;
+}
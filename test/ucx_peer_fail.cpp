@@ -0,0 +1,210 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Kills a loopback peer process and measures how long the UCX engine takes
+// to fail transfers to it: once while writes to it are running, and once
+// while idle, where only the keepalive can find it.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+
+#include "ucx_backend.h"
+
+#define BUF_SIZE (16 * 1024 * 1024)
+
+std::string agent1("Agent1");
+std::string agent2("Agent2");
+
+nixlBackendEngine *createEngine(std::string name, int keepalive_ms)
+{
+    nixlBackendEngine     *ucx;
+    nixlBackendInitParams init;
+    nixl_b_params_t       custom_params;
+
+    custom_params["keepalive_ms"]    = std::to_string(keepalive_ms);
+    custom_params["peer_timeout_ms"] = std::to_string(4 * keepalive_ms);
+
+    init.enableProgTh = false;
+    init.pthrDelay    = 100;
+    init.localAgent   = name;
+    init.customParams = &custom_params;
+    init.type         = "UCX";
+
+    ucx = (nixlBackendEngine*) new nixlUcxEngine (&init);
+    if (ucx->getInitErr()) {
+        std::cout << "Failed to initialize " << name << std::endl;
+        exit(1);
+    }
+    return ucx;
+}
+
+static void sendStr(int fd, const std::string &str)
+{
+    uint64_t len = str.size();
+    assert(write(fd, &len, sizeof(len)) == sizeof(len));
+    assert(write(fd, str.data(), len) == (ssize_t) len);
+}
+
+static std::string recvStr(int fd)
+{
+    uint64_t len;
+    assert(read(fd, &len, sizeof(len)) == sizeof(len));
+    std::string str(len, '\0');
+    for (size_t got = 0; got < len; ) {
+        ssize_t ret = read(fd, &str[got], len - got);
+        assert(ret > 0);
+        got += ret;
+    }
+    return str;
+}
+
+static double nowUs()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec * 1000000.0 + now.tv_usec;
+}
+
+// Target side, progresses until it's killed
+static void runPeer(int fd, int keepalive_ms)
+{
+    nixlBackendEngine *ucx = createEngine(agent2, keepalive_ms);
+    void *buf = calloc(1, BUF_SIZE);
+    nixlBackendMD *md;
+
+    nixlStringDesc reg((uintptr_t) buf, BUF_SIZE, 0, "");
+    assert(ucx->registerMem(reg, DRAM_SEG, md) == NIXL_SUCCESS);
+
+    sendStr(fd, ucx->getConnInfo());
+    sendStr(fd, ucx->getPublicData(md));
+    sendStr(fd, std::to_string((uintptr_t) buf));
+
+    while (true)
+        ucx->progress();
+}
+
+void runMode(bool busy, int keepalive_ms)
+{
+    int fds[2];
+    assert(pipe(fds) == 0);
+
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        close(fds[0]);
+        runPeer(fds[1], keepalive_ms);
+        exit(0);
+    }
+    close(fds[1]);
+
+    nixlBackendEngine *ucx = createEngine(agent1, keepalive_ms);
+    std::string conn_info = recvStr(fds[0]);
+    std::string rkey      = recvStr(fds[0]);
+    uintptr_t raddr       = strtoull(recvStr(fds[0]).c_str(), NULL, 10);
+    close(fds[0]);
+
+    void *buf = calloc(1, BUF_SIZE);
+    nixlBackendMD *lmd, *rmd;
+    nixlStringDesc reg((uintptr_t) buf, BUF_SIZE, 0, "");
+    assert(ucx->registerMem(reg, DRAM_SEG, lmd) == NIXL_SUCCESS);
+    assert(ucx->loadRemoteConnInfo(agent2, conn_info) == NIXL_SUCCESS);
+    assert(ucx->connect(agent2) == NIXL_SUCCESS);
+    nixlStringDesc rinfo(raddr, BUF_SIZE, 0, rkey);
+    assert(ucx->loadRemoteMD(rinfo, DRAM_SEG, agent2, rmd) == NIXL_SUCCESS);
+
+    nixl_meta_dlist_t src(DRAM_SEG), dst(DRAM_SEG);
+    nixlMetaDesc sdesc, ddesc;
+    sdesc.addr      = (uintptr_t) buf;
+    sdesc.len       = BUF_SIZE;
+    sdesc.devId     = 0;
+    sdesc.metadataP = lmd;
+    ddesc.addr      = raddr;
+    ddesc.len       = BUF_SIZE;
+    ddesc.devId     = 0;
+    ddesc.metadataP = rmd;
+    src.addDesc(sdesc);
+    dst.addDesc(ddesc);
+
+    // Writes back to back, and the peer is killed during the fourth one
+    nixl_status_t ret = NIXL_SUCCESS;
+    std::vector<std::string> failed;
+    double kill_time = 0;
+    for (int i = 0; busy && (ret >= 0); i++) {
+        nixlBackendReqH* handle = NULL;
+        ret = ucx->postXfer(src, dst, NIXL_WRITE, agent2, "", handle);
+        if (i == 3) {
+            kill(pid, SIGKILL);
+            kill_time = nowUs();
+        }
+        while (ret == NIXL_IN_PROG)
+            ret = ucx->checkXfer(handle);
+        if (handle)
+            ucx->releaseReqH(handle);
+    }
+
+    if (!busy) {
+        kill(pid, SIGKILL);
+        kill_time = nowUs();
+    }
+
+    // Reported once the ep is closed
+    while (failed.empty()) {
+        ucx->progress();
+        ucx->getFailedConns(failed);
+    }
+    double detect_us = nowUs() - kill_time;
+    assert(failed.size() == 1 && failed[0] == agent2);
+    waitpid(pid, NULL, 0);
+
+    // Nothing can be posted to it anymore
+    nixlBackendReqH* handle;
+    assert(ucx->postXfer(src, dst, NIXL_WRITE, agent2, "", handle) < 0);
+    assert(ucx->genNotif(agent2, "gone") < 0);
+
+    std::cout << (busy ? "writes running" : "idle          ")
+              << ", keepalive " << keepalive_ms << "ms: peer failed "
+              << detect_us / 1000 << "ms after it was killed" << std::endl;
+
+    assert(ucx->unloadMD(rmd) == NIXL_SUCCESS);
+    assert(ucx->disconnect(agent2) == NIXL_SUCCESS);
+    ucx->deregisterMem(lmd);
+    delete ucx;
+    free(buf);
+}
+
+int main(int argc, char **argv)
+{
+    int keepalive_ms = 100;
+
+    // ucx_peer_fail [keepalive ms]
+    if (argc > 1)
+        keepalive_ms = atoi(argv[1]);
+    assert(keepalive_ms > 0);
+
+    runMode(true, keepalive_ms);
+    runMode(false, keepalive_ms);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Makes transfer requests that gather random blocks of paged buffers, as
+// from a block table, with prepared side handles. Compares a new request per
+// gather from index vectors with reusing one request from index arrays.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+#include <sys/time.h>
+
+#include "nixl.h"
+
+#define NUM_BLOCKS  8192
+#define BLOCK_SIZE  4096
+
+std::string agent1("Agent001");
+std::string agent2("Agent002");
+
+static float elapsedUs(struct timeval &start_time, struct timeval &end_time)
+{
+    struct timeval diff_time;
+    timersub(&end_time, &start_time, &diff_time);
+    return (diff_time.tv_sec * 1000000) + diff_time.tv_usec;
+}
+
+void runGather(nixlAgent* agent, nixlXferSideH* local_side,
+               nixlXferSideH* remote_side, int num_indices, int iters)
+{
+    std::vector<int> local_indices(num_indices), remote_indices(num_indices);
+    struct timeval start_time, end_time;
+    unsigned int seed = num_indices;
+    nixlXferReqH* req = nullptr;
+    float new_us, reuse_us;
+
+    for (int i = 0; i < num_indices; i++) {
+        local_indices[i]  = i;
+        remote_indices[i] = rand_r(&seed) % NUM_BLOCKS;
+    }
+
+    gettimeofday(&start_time, NULL);
+    for (int i = 0; i < iters; i++) {
+        assert(agent->makeXferReq(local_side, local_indices, remote_side,
+                                  remote_indices, "", NIXL_WRITE, req)
+               == NIXL_SUCCESS);
+        agent->invalidateXferReq(req);
+    }
+    gettimeofday(&end_time, NULL);
+    new_us = elapsedUs(start_time, end_time);
+
+    req = nullptr;
+    gettimeofday(&start_time, NULL);
+    for (int i = 0; i < iters; i++)
+        assert(agent->makeXferReq(local_side, local_indices.data(),
+                                  remote_side, remote_indices.data(),
+                                  num_indices, "", NIXL_WRITE, req)
+               == NIXL_SUCCESS);
+    gettimeofday(&end_time, NULL);
+    reuse_us = elapsedUs(start_time, end_time);
+
+    // The reused request is still a valid one
+    nixl_status_t ret = agent->postXferReq(req);
+    assert(ret >= NIXL_SUCCESS);
+    while (ret == NIXL_IN_PROG)
+        ret = agent->getXferStatus(req);
+    assert(ret == NIXL_SUCCESS);
+    agent->invalidateXferReq(req);
+
+    std::cout << num_indices << " indices: new request "
+              << new_us * 1000 / iters << "ns, reused request "
+              << reuse_us * 1000 / iters << "ns ("
+              << reuse_us * 1000 / iters / num_indices << "ns per index)"
+              << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int iters = 10000;
+    std::vector<int> index_counts = {16, 64, 256, 1024, 4096};
+
+    // xfer_gather_bench [iterations per index count]
+    if (argc > 1)
+        iters = atoi(argv[1]);
+    assert(iters > 0);
+
+    nixlAgentConfig cfg(true);
+    nixlAgent A1(agent1, cfg);
+    nixlAgent A2(agent2, cfg);
+
+    nixlBackendH* ucx1 = A1.createBackend("UCX", A1.getBackendOptions("UCX"));
+    nixlBackendH* ucx2 = A2.createBackend("UCX", A2.getBackendOptions("UCX"));
+    assert(ucx1 != nullptr && ucx2 != nullptr);
+
+    void* src_buf = calloc(NUM_BLOCKS, BLOCK_SIZE);
+    void* dst_buf = calloc(NUM_BLOCKS, BLOCK_SIZE);
+    nixl_reg_dlist_t src_mem(DRAM_SEG), dst_mem(DRAM_SEG);
+    nixl_xfer_dlist_t src_blocks(DRAM_SEG), dst_blocks(DRAM_SEG);
+
+    // One registration for all blocks, as with a paged cache
+    src_mem.addDesc(nixlStringDesc((uintptr_t) src_buf, NUM_BLOCKS * BLOCK_SIZE, 0));
+    dst_mem.addDesc(nixlStringDesc((uintptr_t) dst_buf, NUM_BLOCKS * BLOCK_SIZE, 0));
+    assert(A1.registerMem(src_mem, ucx1) == NIXL_SUCCESS);
+    assert(A2.registerMem(dst_mem, ucx2) == NIXL_SUCCESS);
+
+    std::string remote_md = A2.getLocalMD();
+    assert(A1.loadRemoteMD(remote_md) == agent2);
+
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        src_blocks.addDesc(nixlBasicDesc((uintptr_t) src_buf + i*BLOCK_SIZE, BLOCK_SIZE, 0));
+        dst_blocks.addDesc(nixlBasicDesc((uintptr_t) dst_buf + i*BLOCK_SIZE, BLOCK_SIZE, 0));
+    }
+
+    nixlXferSideH *local_side, *remote_side;
+    assert(A1.prepXferSide(src_blocks, "", ucx1, local_side) == NIXL_SUCCESS);
+    assert(A1.prepXferSide(dst_blocks, agent2, ucx1, remote_side) == NIXL_SUCCESS);
+
+    for (auto & count : index_counts)
+        runGather(&A1, local_side, remote_side, count, iters);
+
+    A1.invalidateXferSide(local_side);
+    A1.invalidateXferSide(remote_side);
+    assert(A1.invalidateRemoteMD(agent2) == NIXL_SUCCESS);
+    assert(A1.deregisterMem(src_mem, ucx1) == NIXL_SUCCESS);
+    assert(A2.deregisterMem(dst_mem, ucx2) == NIXL_SUCCESS);
+    free(src_buf);
+    free(dst_buf);
+
+    return 0;
+}